@@ -0,0 +1,34 @@
+// Device entry of the stress benchmark, writes the scaling curve to the SD card
+#include "stress.h"
+#include <storage/storage.h>
+
+#define BENCH_FOLDER EXT_PATH("apps_data/f0ge_bench")
+#ifdef F0GE_FIXED_POINT
+#define BENCH_FILE BENCH_FOLDER "/scaling_fixed.csv"
+#else
+#define BENCH_FILE BENCH_FOLDER "/scaling.csv"
+#endif
+
+static void write_line(const char *line, void *context) {
+    File *file = context;
+    storage_file_write(file, line, strlen(line));
+    FURI_LOG_I("BENCH", "%s", line);
+}
+
+int32_t bench_app(void *p) {
+    UNUSED(p);
+    Storage *storage = furi_record_open(RECORD_STORAGE);
+    storage_simply_mkdir(storage, BENCH_FOLDER);
+    File *file = storage_file_alloc(storage);
+
+    if (storage_file_open(file, BENCH_FILE, FSAM_WRITE, FSOM_CREATE_ALWAYS)) {
+        stress_curve(MAKE_STRESS_CONFIG(0), stress_default_steps, stress_default_step_count, write_line, file);
+        storage_file_close(file);
+    } else {
+        FURI_LOG_E("BENCH", "Cannot open %s", BENCH_FILE);
+    }
+
+    storage_file_free(file);
+    furi_record_close(RECORD_STORAGE);
+    return 0;
+}
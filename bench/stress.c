@@ -0,0 +1,225 @@
+#include "stress.h"
+#include "../f0ge/utils/helpers.h"
+
+#define STRESS_WORLD_WIDTH 384
+#define STRESS_WORLD_HEIGHT 192
+#define STRESS_VARIANTS 8
+
+const uint16_t stress_default_steps[] = {10, 25, 50, 100, 200, 350, 500, 750, 1000, 1500, 2000};
+const uint8_t stress_default_step_count = sizeof(stress_default_steps) / sizeof(stress_default_steps[0]);
+
+typedef struct {
+    uint32_t rng;
+    Buffer *textures[3];
+    Buffer *masks[3];
+    RenderData variants[STRESS_VARIANTS];
+    Component *spins;
+    float *speeds;
+    uint8_t *depths;
+    // measurement
+    const StressConfig *config;
+    StressResult *result;
+    size_t last_frame;
+    uint16_t measured;
+} StressScene;
+
+static uint32_t next_random(StressScene *scene) {
+    uint32_t x = scene->rng;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    scene->rng = x;
+    return x;
+}
+
+static float random_range(StressScene *scene, float min, float max) {
+    return min + (float) (next_random(scene) % 10000) / 10000.f * (max - min);
+}
+
+static void spin_update(Node *self, float delta, void *data) {
+    self->transform.rotation += *((float *) data) * delta;
+    self->transform.dirty = true;
+}
+
+static Buffer *make_texture(uint8_t size, bool checker) {
+    Buffer *b = buffer_create(size, size, false);
+    for (uint8_t y = 0; y < size; y++) {
+        for (uint8_t x = 0; x < size; x++) {
+            bool black = checker ? ((x >> 2) + (y >> 2)) & 1 : (x == 0 || y == 0 || x == y);
+            if (black) buffer_set_pixel(b, x, y, COLOR_BLACK);
+        }
+    }
+    return b;
+}
+
+static void make_variants(StressScene *scene) {
+    static const uint8_t sizes[3] = {8, 16, 32};
+    for (uint8_t i = 0; i < 3; i++) {
+        scene->textures[i] = make_texture(sizes[i], i & 1);
+        scene->masks[i] = buffer_create(sizes[i], sizes[i], false);
+        buffer_fill(scene->masks[i], COLOR_BLACK);
+    }
+
+    // sizes from 4 to 48 pixels, every tile mode, a few masks
+    static const struct {
+        uint8_t texture;
+        float size;
+        TileMode tile;
+        bool mask;
+    } variants[STRESS_VARIANTS] = {
+        {0, 4, TILE_NONE, false},
+        {0, 8, TILE_NONE, true},
+        {1, 12, TILE_HORIZONTAL, false},
+        {1, 16, TILE_NONE, true},
+        {1, 24, TILE_VERTICAL, false},
+        {2, 32, TILE_NONE, false},
+        {2, 40, TILE_BOTH, false},
+        {2, 48, TILE_NONE, true},
+    };
+    for (uint8_t i = 0; i < STRESS_VARIANTS; i++) {
+        const float h = variants[i].size / 2;
+        scene->variants[i] = (RenderData) {
+            .poly = RECTANGLE(-h, -h, variants[i].size, variants[i].size),
+            .sprite = scene->textures[variants[i].texture],
+            .mask = variants[i].mask ? scene->masks[variants[i].texture] : NULL,
+            .tile_mode = variants[i].tile,
+            .color = COLOR_BLACK,
+            .mask_color = COLOR_WHITE,
+        };
+    }
+}
+
+// half the nodes hang below an earlier node, the rest are spread over a world a few screens large
+static Node *build_scene(StressScene *scene, const StressConfig *config) {
+    Node *root = allocate(sizeof(Node));
+    *root = MAKE_NODE();
+    Node **nodes = allocate(sizeof(Node *) * config->nodes);
+
+    for (uint16_t i = 0; i < config->nodes; i++) {
+        Node *node = allocate(sizeof(Node));
+        *node = MAKE_NODE();
+        node->sprite = &(scene->variants[next_random(scene) % STRESS_VARIANTS]);
+        node->transform.rotation = random_range(scene, 0, 360);
+
+        uint16_t parent = i > 0 ? next_random(scene) % i : 0;
+        if (i > 0 && (next_random(scene) & 1) && scene->depths[parent] < config->max_depth) {
+            scene->depths[i] = scene->depths[parent] + 1;
+            node->transform.position = (Vector) {random_range(scene, -24, 24), random_range(scene, -24, 24)};
+            add_child(nodes[parent], node);
+        } else {
+            scene->depths[i] = 0;
+            node->transform.position = (Vector) {
+                random_range(scene, -STRESS_WORLD_WIDTH / 2, STRESS_WORLD_WIDTH / 2),
+                random_range(scene, -STRESS_WORLD_HEIGHT / 2, STRESS_WORLD_HEIGHT / 2)
+            };
+            add_child(root, node);
+        }
+
+        // a third of the nodes animate, the rest only move with their parents
+        if (next_random(scene) % 3 == 0) {
+            scene->speeds[i] = random_range(scene, -90, 90);
+            scene->spins[i] = MAKE_COMPONENT();
+            scene->spins[i].update = &spin_update;
+            scene->spins[i].data = &(scene->speeds[i]);
+            add_component(node, &(scene->spins[i]));
+        }
+        nodes[i] = node;
+    }
+    release(nodes);
+    return root;
+}
+
+static void on_frame_end(void *gameState, uint32_t frame, Buffer *buffer) {
+    UNUSED(buffer);
+    StressScene *scene = gameState;
+    const StressConfig *config = scene->config;
+    const size_t now = curr_time();
+
+    if (frame >= config->warmup_frames) {
+        // present of the previous frame is measured after its on_frame_end
+        const FrameStats *stats = engine_frame_stats();
+        StressResult *r = scene->result;
+        r->update += stats->update;
+        r->transform += stats->transform;
+        r->render += stats->render;
+        r->present += stats->present;
+        r->frame += (float) ((uint32_t) now - (uint32_t) scene->last_frame) / CYCLES_PER_US;
+        scene->measured++;
+    }
+    scene->last_frame = now;
+
+    if (scene->measured >= config->measured_frames) engine_exit();
+}
+
+bool stress_run(const StressConfig *config, StressResult *result) {
+    *result = (StressResult) {.nodes = config->nodes};
+    const size_t needed = (size_t) config->nodes * STRESS_NODE_BYTES + 8 * 1024;
+    if (memmgr_get_free_heap() < needed) {
+        FURI_LOG_W("STRESS", "%u nodes need ~%zu bytes, not enough heap", config->nodes, needed);
+        return false;
+    }
+
+    StressScene *scene = allocate(sizeof(StressScene));
+    check_pointer(scene);
+    *scene = (StressScene) {
+        .rng = config->seed * 2654435761u + 1,
+        .config = config,
+        .result = result,
+    };
+    scene->spins = allocate(sizeof(Component) * config->nodes);
+    scene->speeds = allocate(sizeof(float) * config->nodes);
+    scene->depths = allocate(config->nodes);
+    make_variants(scene);
+
+    init_engine((EngineConfig) {
+        .render_fps = 30,
+        .headless = config->headless,
+        .uncapped = true,
+        .profile = true,
+        .backlight = true,
+        .gameState = scene,
+        .on_frame_end = on_frame_end,
+    });
+    set_scene(build_scene(scene, config));
+    scene->last_frame = curr_time();
+    start_loop();
+
+    const bool completed = scene->measured >= config->measured_frames;
+    if (scene->measured > 0) {
+        const float n = scene->measured;
+        result->frames = scene->measured;
+        result->update /= n;
+        result->transform /= n;
+        result->render /= n;
+        result->present /= n;
+        result->frame /= n;
+        result->fps = result->frame > 0 ? 1000000.f / result->frame : 0;
+    }
+
+    for (uint8_t i = 0; i < 3; i++) {
+        buffer_release(scene->textures[i]);
+        buffer_release(scene->masks[i]);
+    }
+    release(scene->spins);
+    release(scene->speeds);
+    release(scene->depths);
+    release(scene);
+    return completed;
+}
+
+void stress_curve(StressConfig config, const uint16_t *steps, uint8_t count, StressOutput output, void *context) {
+    char line[128];
+    output("nodes,frames,update_us,transform_us,render_us,present_us,frame_us,fps\n", context);
+    for (uint8_t i = 0; i < count; i++) {
+        config.nodes = steps[i];
+        StressResult r;
+        const bool completed = stress_run(&config, &r);
+        if (r.frames > 0) {
+            snprintf(line, sizeof(line), "%u,%u,%.1f,%.1f,%.1f,%.1f,%.1f,%.2f\n", r.nodes, r.frames,
+                     (double) r.update, (double) r.transform, (double) r.render, (double) r.present,
+                     (double) r.frame, (double) r.fps);
+            output(line, context);
+        }
+        if (!completed) break;
+    }
+}
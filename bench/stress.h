@@ -0,0 +1,49 @@
+#pragma once
+#include "../f0ge/f0ge.h"
+
+// Generates scenes of a given node count and measures how the frame cost grows with it
+
+// rough heap cost of a generated node (node, rendering data, lists and component data)
+#define STRESS_NODE_BYTES 320
+
+typedef struct {
+    uint16_t nodes;
+    uint8_t max_depth;      // deepest parent chain
+    uint32_t seed;
+    uint16_t warmup_frames;
+    uint16_t measured_frames;
+    bool headless;
+} StressConfig;
+
+#define MAKE_STRESS_CONFIG(n) (StressConfig){ \
+    .nodes=n, \
+    .max_depth=4, \
+    .seed=1, \
+    .warmup_frames=10, \
+    .measured_frames=60, \
+    .headless=false \
+}
+
+// averages per frame in microseconds
+typedef struct {
+    uint16_t nodes;
+    uint16_t frames;
+    float update;
+    float transform;
+    float render;
+    float present;
+    float frame;
+    float fps;
+} StressResult;
+
+typedef void (*StressOutput)(const char *line, void *context);
+
+// builds the scene, runs it through the engine loop and tears it down
+// false if it did not fit in the heap or the run was stopped (long back press)
+bool stress_run(const StressConfig *config, StressResult *result);
+
+// runs the config for every node count and writes a csv line per step, stops at the first step that fails
+void stress_curve(StressConfig config, const uint16_t *steps, uint8_t count, StressOutput output, void *context);
+
+extern const uint16_t stress_default_steps[];
+extern const uint8_t stress_default_step_count;
@@ -2,12 +2,14 @@
 #include "../node.h"
 #include "../graphics/render.h"
 #include "../component.h"
+#include "../context.h"
 
 void cam_follow_update(Node *self, float delta, void *data);
 
-static uint8_t follow_directions = FollowNone;
-static uint8_t edge_left = 0, edge_right = 0, edge_up = 0, edge_down = 0;
-Vector center = {-64, -32};
+static inline CameraFollowState *follow_state() {
+    return &(engine_context_current()->camera_follow);
+}
+
 Component com_camera_follow = {
     .start = NULL,
     .end = NULL,
@@ -18,46 +20,48 @@ void cam_follow_update(Node *self, float delta, void *data) {
     UNUSED(delta);
     UNUSED(data);
 
-    if (follow_directions == FollowNone) return;
+    CameraFollowState *state = follow_state();
+    if (state->directions == FollowNone) return;
 
     Vector pos;
     matrix_get_translation(&(self->transform.transformation_matrix), &pos);
 
     //shift coordinates to center
-    vector_add(&center, &pos, &pos);
+    vector_add(&(state->center), &pos, &pos);
 
     //if all side is half the screen, just set the position to the node position
-    if (edge_left == 64 || edge_right == 64 || edge_up == 32 || edge_down == 32) {
+    if (state->edge_left == 64 || state->edge_right == 64 || state->edge_up == 32 || state->edge_down == 32) {
         set_camera(pos);
     }
     else {
         Vector current_cam_pos = get_camera();
         //based on edge config and follow mask move the camera
-        if (follow_directions & FollowLeft && pos.x < (current_cam_pos.x - edge_left)) {
-            current_cam_pos.x += (pos.x - current_cam_pos.x + edge_left);
+        if (state->directions & FollowLeft && pos.x < (current_cam_pos.x - state->edge_left)) {
+            current_cam_pos.x += (pos.x - current_cam_pos.x + state->edge_left);
         }
-        else if (follow_directions & FollowRight && pos.x > (current_cam_pos.x + edge_right)) {
-            current_cam_pos.x += (pos.x - current_cam_pos.x - edge_right);
+        else if (state->directions & FollowRight && pos.x > (current_cam_pos.x + state->edge_right)) {
+            current_cam_pos.x += (pos.x - current_cam_pos.x - state->edge_right);
         }
-        if (follow_directions & FollowUp && pos.y < (current_cam_pos.y - edge_up)) {
-            current_cam_pos.y += (pos.y - current_cam_pos.y + edge_up);
+        if (state->directions & FollowUp && pos.y < (current_cam_pos.y - state->edge_up)) {
+            current_cam_pos.y += (pos.y - current_cam_pos.y + state->edge_up);
         }
-        else if (follow_directions & FollowDown && pos.y > (current_cam_pos.y + edge_down)) {
-            current_cam_pos.y += (pos.y - current_cam_pos.y - edge_down);
+        else if (state->directions & FollowDown && pos.y > (current_cam_pos.y + state->edge_down)) {
+            current_cam_pos.y += (pos.y - current_cam_pos.y - state->edge_down);
         }
         set_camera(current_cam_pos);
     }
 }
 void cam_shift(Vector amount) {
-    center = (Vector){-amount.x, -amount.y};
+    follow_state()->center = (Vector){-amount.x, -amount.y};
 }
 void cam_follow_set_area(uint8_t left, uint8_t right, uint8_t up, uint8_t down) {
-    edge_left = left;
-    edge_right = right;
-    edge_up = up;
-    edge_down = down;
+    CameraFollowState *state = follow_state();
+    state->edge_left = left;
+    state->edge_right = right;
+    state->edge_up = up;
+    state->edge_down = down;
 }
 
 void cam_follow_set_directions(uint8_t directions) {
-    follow_directions = directions;
+    follow_state()->directions = directions;
 }
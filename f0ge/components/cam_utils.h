@@ -11,6 +11,18 @@ enum CamFollowDirection {
     FollowDown=1<<4
 };
 
+// per engine context settings of com_camera_follow
+typedef struct {
+    uint8_t directions;
+    uint8_t edge_left, edge_right, edge_up, edge_down;
+    Vector center;
+} CameraFollowState;
+
+#define DEFAULT_CAMERA_FOLLOW_STATE { \
+    .directions=FollowNone, \
+    .center={-64, -32} \
+}
+
 extern Component com_camera_follow;
 
 
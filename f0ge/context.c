@@ -0,0 +1,44 @@
+#include "context.h"
+#include "utils/helpers.h"
+
+#ifdef F0GE_HOST
+#define F0GE_THREAD_LOCAL _Thread_local
+#else
+#define F0GE_THREAD_LOCAL
+#endif
+
+#define DEFAULT_ENGINE_CONTEXT { \
+    .render=DEFAULT_RENDER_STATE, \
+    .audio=DEFAULT_AUDIO_STATE, \
+    .replay=DEFAULT_REPLAY_STATE, \
+    .camera_follow=DEFAULT_CAMERA_FOLLOW_STATE, \
+    .fonts=DEFAULT_FONT_STATE, \
+    .schedules=NULL, \
+    .tweeners=NULL, \
+    .icons=NULL \
+}
+
+// used until a context is bound, keeps single instance games working without any setup
+static EngineContext default_context = DEFAULT_ENGINE_CONTEXT;
+static F0GE_THREAD_LOCAL EngineContext *current_context = NULL;
+
+EngineContext *engine_context_create() {
+    EngineContext *context = allocate(sizeof(EngineContext));
+    check_pointer(context);
+    *context = (EngineContext) DEFAULT_ENGINE_CONTEXT;
+    return context;
+}
+
+void engine_context_release(EngineContext *context) {
+    if (!context) return;
+    if (current_context == context) current_context = NULL;
+    release(context);
+}
+
+void engine_context_bind(EngineContext *context) {
+    current_context = context;
+}
+
+EngineContext *engine_context_current() {
+    return current_context ? current_context : &default_context;
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include "f0ge_types.h"
+#include "utils/list.h"
+#include "utils/audio.h"
+#include "utils/replay.h"
+#include "graphics/render.h"
+#include "graphics/font.h"
+#include "components/cam_utils.h"
+
+typedef struct EngineContext EngineContext;
+
+// everything a running engine instance owns, the public api works on the current context
+struct EngineContext {
+    RuntimeData runtime;
+    EngineConfig config;
+    RenderState render;
+    AudioState audio;
+    ReplayState replay;
+    CameraFollowState camera_follow;
+    FontState fonts;
+    List *schedules;
+    List *tweeners;
+    List *icons;
+};
+
+EngineContext *engine_context_create();
+
+void engine_context_release(EngineContext *context);
+
+// selects the context used by the engine calls of the current thread, NULL selects the default one
+// host builds (F0GE_HOST) keep one binding per thread, on the device there is a single binding
+void engine_context_bind(EngineContext *context);
+
+EngineContext *engine_context_current();
@@ -1,94 +1,228 @@
 #include <notification/notification_messages.h>
 #include "f0ge.h"
+#include "context.h"
 #include "component.h"
 #include "node.h"
+#include "node_pool.h"
 #include "utils/helpers.h"
+#include "math/equation.h"
 #include "utils/tweener.h"
 #include "utils/scheduler.h"
 #include "utils/audio.h"
 #include "graphics/asset.h"
 #include "graphics/render.h"
+#include "graphics/layer.h"
+#include "graphics/ui.h"
 
 //TODO LEAKING MEMORY somewhere
-static RuntimeData runtimeData;
-static EngineConfig engineConfig;
+static inline RuntimeData *runtime_data() {
+    return &(engine_context_current()->runtime);
+}
 
-struct RenderingData {
-    Node *node;
-    Vector cachedCorners[4];
-};
+static inline EngineConfig *engine_config() {
+    return &(engine_context_current()->config);
+}
 
 RenderingData *make_rendering_data(Node *node) {
-    RenderingData *data = allocate(sizeof(RenderingData));
+    RenderingData *data = node->_rendering_data;
+    //keep the cache if the node is added again after a removal
+    if (data == NULL) {
+        data = allocate(sizeof(RenderingData));
+        *data = EMPTY_RENDERING_DATA;
+    }
     data->node = node;
-    for (int i = 0; i < 4; i++) {
-        data->cachedCorners[i] = node->sprite->poly.corners[i];
+    if (node->sprite) {
+        for (int i = 0; i < 4; i++) {
+            data->cachedCorners[i] = node->sprite->poly.corners[i];
+        }
+    }
+    Mesh *mesh = node->sprite ? node->sprite->mesh : NULL;
+    if (mesh) {
+        if (data->cachedVertexCount != mesh->vertex_count) {
+            if (data->cachedVertices) release(data->cachedVertices);
+            data->cachedVertices = allocate(sizeof(Vector) * mesh->vertex_count);
+            check_pointer(data->cachedVertices);
+            data->cachedVertexCount = mesh->vertex_count;
+        }
+        memcpy(data->cachedVertices, mesh->vertices, sizeof(Vector) * mesh->vertex_count);
     }
     node->_rendering_data = data;
     return data;
 }
 
+static void release_rendering_cache(RenderingData *data) {
+    if (data->cachedVertices) release(data->cachedVertices);
+    data->cachedVertexCount = 0;
+}
+
 InputType get_key_state(InputKey key) {
-    return runtimeData.inputState[key];
+    return runtime_data()->inputState[key];
 }
 
 bool is_down(InputKey key) {
-    return runtimeData.inputState[key] == InputTypeLong || runtimeData.inputState[key] == InputTypePress;
+    RuntimeData *runtime = runtime_data();
+    return runtime->inputState[key] == InputTypeLong || runtime->inputState[key] == InputTypePress;
 }
 
 bool is_pressed(InputKey key) {
-    return runtimeData.inputState[key] == InputTypePress;
+    return runtime_data()->inputState[key] == InputTypePress;
 }
 
 bool is_up(InputKey key) {
-    return runtimeData.inputState[key] == InputTypeRelease;
+    return runtime_data()->inputState[key] == InputTypeRelease;
 }
 
-static void gui_input_events_callback(const void *value, void *ctx) {
-    RuntimeData *data = ctx;
-    const InputEvent *event = value;
+static void apply_input(RuntimeData *data, InputKey key, InputType type) {
+    if (type == InputTypeRepeat) return;
 
-    if (event->type == InputTypeRepeat) return;
+    replay_record_input(key, type);
 
-    furi_mutex_acquire(data->update_mutex, FuriWaitForever);
-    if (event->key == InputKeyBack && event->type == InputTypeLong) {
+    if (key == InputKeyBack && type == InputTypeLong) {
         data->exit = true;
     }
 
+    data->inputState[key] = type;
+}
 
-    data->inputState[event->key] = event->type;
+static void gui_input_events_callback(const void *value, void *ctx) {
+    RuntimeData *data = ctx;
+    const InputEvent *event = value;
 
+    furi_mutex_acquire(data->update_mutex, FuriWaitForever);
+    if (replay_accepts_input(event->key, event->type))
+        apply_input(data, event->key, event->type);
     furi_mutex_release(data->update_mutex);
 }
 
+void engine_inject_input(InputKey key, InputType type) {
+    apply_input(runtime_data(), key, type);
+}
+
+void engine_exit() {
+    runtime_data()->exit = true;
+}
+
+const FrameStats *engine_frame_stats() {
+    return &(runtime_data()->stats);
+}
+
+uint32_t engine_get_tick() {
+    return runtime_data()->tick;
+}
+
 void change_ui_renderer(void (*render_ui)(void *gameState, Canvas *canvas)) {
-    engineConfig.render_ui = render_ui;
+    engine_config()->render_ui = render_ui;
+}
+
+void set_ui_layer(UiLayer *ui) {
+    RuntimeData *runtime = runtime_data();
+    if (runtime->ui != ui) ui_release(runtime->ui);
+    runtime->ui = ui;
+}
+
+UiLayer *get_ui_layer() {
+    return runtime_data()->ui;
 }
 
 void init_engine(EngineConfig config) {
-    engineConfig = config;
-    runtimeData.update_mutex = (FuriMutex *) furi_mutex_alloc(FuriMutexTypeNormal);
-    runtimeData.exit = false;
-    runtimeData.volume = config.volume;
-    runtimeData.muted = config.muted;
-    runtimeData.input = furi_record_open(RECORD_INPUT_EVENTS);
-    runtimeData.renderInstance.gui = furi_record_open(RECORD_GUI);
-    runtimeData.renderInstance.canvas = gui_direct_draw_acquire(runtimeData.renderInstance.gui);
-    runtimeData.input_subscription = furi_pubsub_subscribe(runtimeData.input, gui_input_events_callback, &runtimeData);
-    runtimeData.notification_app = (NotificationApp *) furi_record_open(RECORD_NOTIFICATION);
-
-    if (config.backlight)
-        notification_message_block(runtimeData.notification_app, &sequence_display_backlight_enforce_on);
-
-    runtimeData.renderInstance.buffer = buffer_create(SCREEN_WIDTH, SCREEN_HEIGHT, false);
-
-    runtimeData.renderers = list_make();
-
-    tweener_prepare(&runtimeData);
-    scheduler_prepare(&runtimeData);
-    setup_audio(runtimeData.notification_app);
+    RuntimeData *runtime = runtime_data();
+    *engine_config() = config;
+    runtime->update_mutex = (FuriMutex *) furi_mutex_alloc(FuriMutexTypeNormal);
+    runtime->exit = false;
+    //games that never set it play at full volume
+    runtime->volume = config.volume ? config.volume : 100;
+    runtime->muted = config.muted;
+    runtime->frame = 0;
+    runtime->tick = 0;
+    runtime->stats = (FrameStats) {0};
+
+    if (!config.headless) {
+        runtime->input = furi_record_open(RECORD_INPUT_EVENTS);
+        runtime->renderInstance.gui = furi_record_open(RECORD_GUI);
+        runtime->renderInstance.canvas = gui_direct_draw_acquire(runtime->renderInstance.gui);
+        runtime->input_subscription = furi_pubsub_subscribe(runtime->input, gui_input_events_callback, runtime);
+        runtime->notification_app = (NotificationApp *) furi_record_open(RECORD_NOTIFICATION);
+
+        if (config.backlight)
+            notification_message_block(runtime->notification_app, &sequence_display_backlight_enforce_on);
+    } else {
+        runtime->notification_app = NULL;
+    }
+
+    runtime->renderInstance.buffer = buffer_create(SCREEN_WIDTH, SCREEN_HEIGHT, false);
+
+    tweener_prepare(runtime);
+    scheduler_prepare(runtime);
+    setup_audio(runtime->notification_app);
+    set_volume(runtime->volume / 100.0f);
+    set_muted(config.muted);
     for (uint8_t i = 0; i < 6; i++) {
-        runtimeData.inputState[i] = InputTypeMAX;
+        runtime->inputState[i] = InputTypeMAX;
+    }
+}
+
+static bool node_wants_update(Node *node) {
+    VEC_FOREACH(item, &(node->components)) {
+        Component *c = item;
+        if (c->update) return true;
+    }
+    return false;
+}
+
+static bool node_is_asleep(Node *node) {
+    for (; node; node = node->parent) {
+        if (node->sleeping) return true;
+    }
+    return false;
+}
+
+static void update_set_add(Node *node) {
+    RuntimeData *runtime = runtime_data();
+    if (node->_updating || !node->active || node_is_asleep(node)) return;
+    node->_updating = true;
+    node->_update_next = NULL;
+    node->_update_prev = runtime->update_tail;
+    if (runtime->update_tail)
+        runtime->update_tail->_update_next = node;
+    else
+        runtime->update_head = node;
+    runtime->update_tail = node;
+}
+
+static void update_set_remove(Node *node) {
+    RuntimeData *runtime = runtime_data();
+    if (!node->_updating) return;
+    //keep the update loop valid if the node is removed while it is iterating
+    if (runtime->update_cursor == node) runtime->update_cursor = node->_update_next;
+    if (runtime->update_current == node) runtime->update_current = NULL;
+
+    if (node->_update_prev)
+        node->_update_prev->_update_next = node->_update_next;
+    else
+        runtime->update_head = node->_update_next;
+
+    if (node->_update_next)
+        node->_update_next->_update_prev = node->_update_prev;
+    else
+        runtime->update_tail = node->_update_prev;
+
+    node->_update_prev = NULL;
+    node->_update_next = NULL;
+    node->_updating = false;
+}
+
+static void update_set_add_tree(Node *node) {
+    if (node->sleeping) return;
+    if (node_wants_update(node) || node->transform.dirty) update_set_add(node);
+    VEC_FOREACH(child, &(node->children)) {
+        update_set_add_tree(child);
+    }
+}
+
+static void update_set_remove_tree(Node *node) {
+    update_set_remove(node);
+    VEC_FOREACH(child, &(node->children)) {
+        update_set_remove_tree(child);
     }
 }
 
@@ -99,25 +233,22 @@ void node_added(Node *node) {
     // matrix_reset(&(node->transform.transformation_matrix));
     node->active = true;
 
-    if (node->children == NULL) node->children = list_make();
-    if (node->components == NULL) node->components = list_make();
-
     if (node->render_callback || node->sprite) {
-        list_push_back(
-            make_rendering_data(node),
-            runtimeData.renderers
-        );
+        make_rendering_data(node);
     }
 
-    FOREACH(n, node->components) {
-        Component *c = n->data;
+    //indexed, start callbacks may add components or children
+    for (uint16_t i = 0; i < node->components.count; i++) {
+        Component *c = vec_at(&(node->components), i);
         /*c->started = true;
         c->node = node;*/
         if (c->start) c->start(node, c->data);
     }
 
-    FOREACH(n, node->children) {
-        Node *c = n->data;
+    if (node_wants_update(node)) update_set_add(node);
+
+    for (uint16_t i = 0; i < node->children.count; i++) {
+        Node *c = vec_at(&(node->children), i);
         c->parent = node;
         node_added(c);
     }
@@ -125,84 +256,134 @@ void node_added(Node *node) {
 
 void node_removed(Node *node) {
     if (!node) return;
-    node->_rendering_data = NULL;
+    node_invalidate(node->parent);
+    node->active = false;
     set_renderer_dirty();
-    FOREACH(n, node->children) {
-        node_removed(n->data);
+    update_set_remove(node);
+    VEC_FOREACH(child, &(node->children)) {
+        node_removed(child);
     }
-    FOREACH(n, node->components) {
-        Component *c = n->data;
+    VEC_FOREACH(item, &(node->components)) {
+        Component *c = item;
         if (c->end) c->end(node, c->data);
     }
-
-    //remove renderer if had one
-    if (node->sprite) {
-        FOREACH(n, runtimeData.renderers) {
-            if (n->data == node) {
-                list_remove_item(n, runtimeData.renderers);
-                release(n);
-                break;
-            }
-        }
-    }
 }
 
 void node_free(Node *node) {
     if (!node) return;
-    FOREACH(n, node->children) {
-        node_free(n->data);
+    VEC_FOREACH(child, &(node->children)) {
+        node_free(child);
     }
-    node->_rendering_data = NULL;
+    update_set_remove(node);
 
-    FOREACH(n, node->components) {
-        Component *c = n->data;
+    VEC_FOREACH(item, &(node->components)) {
+        Component *c = item;
         if (c->end) c->end(node, c->data);
     }
 
-    //remove renderer if had one
-    if (node->sprite) {
-        FOREACH(n, runtimeData.renderers) {
-            if (n->data == node) {
-                list_remove_item(n, runtimeData.renderers);
-                release(n);
-                break;
-            }
-        }
+    if (node->_static_cache) {
+        layer_release(node->_static_cache);
+        node->_static_cache = NULL;
+    }
+    if (node->_scroll_cache) {
+        layer_release(node->_scroll_cache);
+        node->_scroll_cache = NULL;
     }
 
-    list_clear(node->components);
-    list_clear(node->children);
+    // the children were released above and the components are not owned by the node
+    vec_clear(&(node->components));
+    vec_clear(&(node->children));
+    if (node->_rendering_data) release_rendering_cache(node->_rendering_data);
 
+    if (node->_pool) {
+        node_pool_recycle(node);
+        return;
+    }
+    if (node->_block) {
+        //the root is freed after all of its descendants
+        void *block = node->_block;
+        if (block == node) release(block);
+        return;
+    }
+    if (node->_rendering_data) release(node->_rendering_data);
     release(node);
 }
 
 void cleanup_engine() {
-    node_free(runtimeData.root);
+    RuntimeData *runtime = runtime_data();
+    replay_stop();
+    node_free(runtime->root);
+    runtime->root = NULL;
+    ui_release(runtime->ui);
+    runtime->ui = NULL;
     tweener_cleanup();
     scheduler_cleanup();
-    list_free_data(runtimeData.renderers);
-    release(runtimeData.renderers);
 
     asset_cleanup();
+    cleanup_audio();
+
+    buffer_release(runtime->renderInstance.buffer);
 
-    buffer_release(runtimeData.renderInstance.buffer);
+    furi_mutex_free(runtime->update_mutex);
 
-    furi_mutex_free(runtimeData.update_mutex);
+    if (engine_config()->headless) return;
 
-    furi_pubsub_unsubscribe(runtimeData.input, runtimeData.input_subscription);
-    gui_direct_draw_release(runtimeData.renderInstance.gui);
+    furi_pubsub_unsubscribe(runtime->input, runtime->input_subscription);
+    gui_direct_draw_release(runtime->renderInstance.gui);
     furi_record_close(RECORD_GUI);
     furi_record_close(RECORD_INPUT_EVENTS);
 
-    runtimeData.renderInstance.canvas = NULL;
+    runtime->renderInstance.canvas = NULL;
 
-    notification_message_block(runtimeData.notification_app, &sequence_display_backlight_enforce_auto);
+    notification_message_block(runtime->notification_app, &sequence_display_backlight_enforce_auto);
     furi_record_close(RECORD_NOTIFICATION);
 }
 
-Matrix temp_matrix;
+// recomputes the subtree bounds from the cached corners and the bounds of the children
+static void node_refresh_bounds(Node *node) {
+    if (node->render_callback && !node->draw_bounds) {
+        //custom renderers can draw anywhere
+        node->bounds = BOUNDS_INFINITE;
+        return;
+    }
 
-void update_transform(Node *node) {
+    node->bounds = BOUNDS_EMPTY;
+    node->_flips = false;
+    RenderData *sprite = node->sprite;
+    RenderingData *data = node->_rendering_data;
+    if (node->render_callback) {
+        //the callback draws instead of the sprite
+        node->bounds = *(node->draw_bounds);
+    } else if (sprite) {
+        node->_flips = sprite->color == COLOR_FLIP || (sprite->mask && sprite->mask_color == COLOR_FLIP);
+        if (data && sprite->mesh) {
+            for (uint8_t i = 0; i < data->cachedVertexCount; i++) {
+                bounds_add_point(&(node->bounds), &(data->cachedVertices[i]));
+            }
+        } else if (data) {
+            for (int i = 0; i < 4; i++) {
+                bounds_add_point(&(node->bounds), &(data->cachedCorners[i]));
+            }
+        }
+    }
+    VEC_FOREACH(child, &(node->children)) {
+        Node *c = child;
+        if (!c->active) continue;
+        bounds_merge(&(node->bounds), &(c->bounds));
+        node->_flips |= c->_flips;
+    }
+}
+
+void node_invalidate(Node *node) {
+    for (; node; node = node->parent) {
+        if (node->_static_cache) node->_static_cache->dirty = true;
+        if (node->_scroll_cache) node->_scroll_cache->dirty = true;
+    }
+}
+
+// returns true if the bounds of the subtree had to be recomputed
+static bool update_transform_tree(Node *node) {
+    bool changed = node->transform.dirty;
     if (node->transform.dirty == true) {
         set_renderer_dirty();
         //compute from top to bottom to have a correct matrix for relative positions
@@ -214,94 +395,425 @@ void update_transform(Node *node) {
                 matrix_mul_vector(&(node->transform.transformation_matrix), &(node->sprite->poly.corners[i]),
                                   &(node->_rendering_data->cachedCorners[i]));
             }
+            //mesh vertices are transformed once here and shared by all of its triangles
+            Mesh *mesh = node->sprite->mesh;
+            for (uint8_t i = 0; mesh && i < node->_rendering_data->cachedVertexCount; i++) {
+                matrix_mul_vector(&(node->transform.transformation_matrix), &(mesh->vertices[i]),
+                                  &(node->_rendering_data->cachedVertices[i]));
+            }
         }
     }
 
 
-    check_pointer(node->children);
-    FOREACH(child, node->children) {
-        check_pointer(child);
-        check_pointer(child->data);
-        Node *c = child->data;
+    VEC_FOREACH(child, &(node->children)) {
+        Node *c = child;
         check_pointer(c);
         c->transform.dirty = node->transform.dirty || c->transform.dirty;
-        update_transform(child->data);
+        //sleeping subtrees keep the dirty flag and catch up in node_wake
+        if (c->sleeping) continue;
+        changed |= update_transform_tree(c);
+    }
+    if (changed) {
+        node_refresh_bounds(node);
+        if (node->_static_cache) node->_static_cache->dirty = true;
+        if (node->_scroll_cache) node->_scroll_cache->dirty = true;
     }
     node->transform.dirty = false;
+    return changed;
+}
+
+// flags the ancestors for refresh_bounds, the walk stops at the first flagged one since its ancestors are flagged too
+static void mark_ancestor_bounds(Node *node) {
+    for (Node *p = node; p && p->active && !p->_bounds_dirty; p = p->parent) {
+        p->_bounds_dirty = true;
+    }
+}
+
+// merges the flagged bounds once per frame, children first. Merging right away in every update_transform
+// made a parent with N moving children redo its N children N times.
+static void refresh_bounds(Node *node) {
+    if (!node || !node->_bounds_dirty) return;
+    node->_bounds_dirty = false;
+    VEC_FOREACH(child, &(node->children)) {
+        refresh_bounds(child);
+    }
+    node_refresh_bounds(node);
+}
+
+void node_bounds_changed(Node *node) {
+    node_invalidate(node);
+    set_renderer_dirty();
+    //the node itself is merged again with its ancestors
+    mark_ancestor_bounds(node);
+}
+
+void update_transform(Node *node) {
+    if (!update_transform_tree(node)) return;
+    node_invalidate(node->parent);
+
+    mark_ancestor_bounds(node->parent);
+}
+
+void node_destroy(Node *node) {
+    if (!node) return;
+    RuntimeData *runtime = runtime_data();
+    Node *parent = node->parent;
+    if (parent) {
+        vec_remove(&(parent->children), node);
+        node_invalidate(parent);
+        set_renderer_dirty();
+        mark_ancestor_bounds(parent);
+    }
+    if (runtime->root == node) runtime->root = NULL;
+    node_free(node);
 }
 
 
 void set_scene(Node *root) {
-    if (runtimeData.root)
-        node_removed(runtimeData.root);
-    runtimeData.root = root;
+    RuntimeData *runtime = runtime_data();
+    if (runtime->root)
+        node_removed(runtime->root);
+    runtime->root = root;
     node_added(root);
     update_transform(root);
 }
 
 void add_component(Node *node, Component *component) {
-    if (node->components == NULL) node->components = list_make();
-    list_push_back(component, node->components);
+    vec_push(&(node->components), component);
     if (!node->active) return;
-    component->start(node, component->data);
+    if (component->start) component->start(node, component->data);
+    if (component->update) update_set_add(node);
 }
 
 void add_child(Node *parent, Node *child) {
-    if (parent->children == NULL) parent->children = list_make();
-
-    list_push_back(child, parent->children);
+    vec_push(&(parent->children), child);
     if (!parent->active) return;
     child->parent = parent;
     node_added(child);
     update_transform(child);
 }
 
-void update(Node *node) {
-    if (!node->active) return;
+void node_set_sprite(Node *node, RenderData *sprite) {
+    node->sprite = sprite;
+    if (node->active && (sprite || node->render_callback)) make_rendering_data(node);
+    node_set_dirty(node);
+}
+
+void node_set_dirty(Node *node) {
+    node->transform.dirty = true;
+    update_set_add(node);
+}
+
+void node_sleep(Node *node) {
+    node->sleeping = true;
+    update_set_remove_tree(node);
+}
+
+void node_wake(Node *node) {
+    node->sleeping = false;
+    if (!node->active || node_is_asleep(node)) return;
+    //the parent might have moved while the subtree was sleeping
+    node->transform.dirty = true;
+    update_set_add_tree(node);
+}
+
+// world space area covered by the screen
+static Bounds get_view_bounds() {
+    RuntimeData *runtime = runtime_data();
+    Vector camera = get_camera();
+    return (Bounds){
+        .min=camera,
+        .max={camera.x + runtime->renderInstance.buffer->width, camera.y + runtime->renderInstance.buffer->height}
+    };
+}
+
+// throttles nodes far outside the view, returns true if the node should skip this frame
+static bool update_lod_skip(Node *node, Bounds *view, float *delta) {
+    EngineConfig *config = engine_config();
+    if (config->lod_interval <= 1 || config->lod_distance <= 0) return false;
+
+    if (bounds_distance(&(node->bounds), view) <= config->lod_distance) {
+        node->_lod_skipped = 0;
+        node->_lod_delta = 0;
+        return false;
+    }
+
+    node->_lod_delta += runtime_data()->delta_time;
+    if (++node->_lod_skipped < config->lod_interval) return true;
 
-    FOREACH(comp, node->components) {
-        Component *c = comp->data;
-        if (c->update) c->update(node, runtimeData.delta_time, c->data);
-        if (node->transform.dirty) update_transform(node);
+    //run with the time accumulated while it was skipped
+    *delta = node->_lod_delta;
+    node->_lod_skipped = 0;
+    node->_lod_delta = 0;
+    return false;
+}
+
+// microseconds since a curr_time() reading
+static inline float elapsed_us(size_t start) {
+    return (float) ((uint32_t) curr_time() - (uint32_t) start) / CYCLES_PER_US;
+}
+
+static void apply_transform(RuntimeData *runtime, Node *node) {
+    if (!engine_config()->profile) {
+        update_transform(node);
+        return;
     }
+    size_t start = curr_time();
+    update_transform(node);
+    runtime->stats.transform += elapsed_us(start);
+}
+
+// only visits the active update set, idle nodes and static subtrees are never touched
+void update() {
+    RuntimeData *runtime = runtime_data();
+    Bounds view = get_view_bounds();
+    Node *node = runtime->update_head;
+    while (node) {
+        runtime->update_cursor = node->_update_next;
+
+        float delta = runtime->delta_time;
+        if (update_lod_skip(node, &view, &delta)) {
+            node = runtime->update_cursor;
+            continue;
+        }
+
+        //indexed, an update may add components to its own node
+        runtime->update_current = node;
+        for (uint16_t i = 0; i < node->components.count; i++) {
+            Component *c = vec_at(&(node->components), i);
+            if (c->update) c->update(node, delta, c->data);
+            //the node left the set in its own update (despawned, removed or put to sleep),
+            //it may have been freed, so only the pointer is compared
+            if (runtime->update_current != node) break;
+            if (node->transform.dirty) apply_transform(runtime, node);
+        }
+        if (runtime->update_current != node) {
+            node = runtime->update_cursor;
+            continue;
+        }
+        runtime->update_current = NULL;
+        if (node->transform.dirty) apply_transform(runtime, node);
 
-    FOREACH(child, node->children) {
-        update(child->data);
+        //nodes only queued for a transform change leave the set once it is applied
+        if (!node_wants_update(node)) update_set_remove(node);
+
+        node = runtime->update_cursor;
     }
+    runtime->update_cursor = NULL;
+
+    size_t start = curr_time();
+    refresh_bounds(runtime->root);
+    if (engine_config()->profile) runtime->stats.transform += elapsed_us(start);
 }
 
-void render() {
-    FOREACH(r, runtimeData.renderers) {
-        RenderingData *rd = r->data;
+static bool render_static(Node *node, Buffer *buffer);
 
-        set_transform(&(rd->node->transform.transformation_matrix));
-        if (rd->node->render_callback) {
+static bool render_scroll(Node *node, Buffer *buffer);
+
+// walks the tree in order, whole subtrees outside the view are skipped with a single test
+static void render_node(Node *node, Buffer *buffer, Bounds *view, bool use_cache) {
+    if (!node->active || !bounds_overlaps(&(node->bounds), view)) return;
+    if (use_cache && node->is_static && render_static(node, buffer)) return;
+    if (use_cache && node->scroll_layer && render_scroll(node, buffer)) return;
+
+    RenderingData *rd = node->_rendering_data;
+    if (rd) {
+        set_transform(&(node->transform.transformation_matrix));
+        if (node->render_callback) {
             // FURI_LOG_D("-","---------------------------");
             // Timer *t = timer_start("node render");
-            rd->node->render_callback(rd->node, runtimeData.renderInstance.buffer);
+            node->render_callback(node, buffer);
             // timer_end(t);
-        } else if (rd->node->sprite) {
-            rasterize(runtimeData.renderInstance.buffer, rd->node->sprite, rd->cachedCorners);
+        } else if (node->sprite && node->sprite->mesh) {
+            rasterize_mesh(buffer, node->sprite, rd->cachedVertices);
+        } else if (node->sprite) {
+            rasterize(buffer, node->sprite, rd->cachedCorners);
         }
     }
+
+    VEC_FOREACH(child, &(node->children)) {
+        render_node(child, buffer, view, use_cache);
+    }
+}
+
+typedef struct {
+    Node *node;
+    Bounds view;
+} SubtreeDraw;
+
+// renders a subtree into a layer cache
+static void draw_subtree(Buffer *target, void *context) {
+    SubtreeDraw *draw = context;
+    render_node(draw->node, target, &(draw->view), false);
+}
+
+// composites the cached subtree, returns false if it cannot be cached and has to be rendered normally
+static bool render_static(Node *node, Buffer *buffer) {
+    Bounds *bounds = &(node->bounds);
+    //also rejects subtrees with unbounded custom renderers, those have infinite bounds
+    if (node->_flips) return false;
+    if (bounds->max.x - bounds->min.x >= LAYER_MAX_SIZE || bounds->max.y - bounds->min.y >= LAYER_MAX_SIZE)
+        return false;
+
+    int16_t x = FLOOR(bounds->min.x);
+    int16_t y = FLOOR(bounds->min.y);
+    int16_t width = ((int16_t) CEIL(bounds->max.x) - x + 8) & ~7;
+    int16_t height = (int16_t) CEIL(bounds->max.y) - y + 1;
+    if (width > LAYER_MAX_SIZE || height > LAYER_MAX_SIZE) return false;
+
+    LayerCache *cache = node->_static_cache;
+    if (cache && (cache->color->width != width || cache->color->height != height)) {
+        layer_release(cache);
+        cache = NULL;
+    }
+    if (!cache) {
+        cache = layer_create(width, height);
+        node->_static_cache = cache;
+    }
+
+    Vector camera = get_camera();
+    if (cache->dirty) {
+        cache->origin = (Vector){x, y};
+        SubtreeDraw draw = {.node=node, .view=node->bounds};
+        set_camera(cache->origin);
+        layer_draw(cache, draw_subtree, &draw);
+        set_camera(camera);
+    }
+
+    layer_composite(cache, buffer, (int16_t) roundf(x - camera.x), (int16_t) roundf(y - camera.y));
+    return true;
+}
+
+// redraws a screen space strip of a scroll layer
+static void render_scroll_strip(Node *node, LayerCache *cache, int16_t x, int16_t y, int16_t width, int16_t height) {
+    Vector camera = get_camera();
+    SubtreeDraw draw = {
+        .node=node,
+        .view={.min={camera.x + x, camera.y + y}, .max={camera.x + x + width, camera.y + y + height}}
+    };
+    set_clip(x, y, width, height);
+    layer_draw_area(cache, x, y, width, height, draw_subtree, &draw);
+    reset_clip();
+}
+
+// The layer follows the camera in whole pixels: it is drawn and scrolled at the camera rounded down,
+// so a fractional camera (e.g. following a node) still reuses the last frame and only renders the exposed strips.
+static bool render_scroll(Node *node, Buffer *buffer) {
+    //unbounded custom renderers would be drawn into every strip
+    if (node->_flips || bounds_is_infinite(&(node->bounds))) return false;
+
+    LayerCache *cache = node->_scroll_cache;
+    if (!cache) {
+        cache = layer_create(buffer->width, buffer->height);
+        node->_scroll_cache = cache;
+    }
+
+    const int16_t width = cache->color->width;
+    const int16_t height = cache->color->height;
+    Vector camera = get_camera();
+    Vector snapped = {FLOOR(camera.x), FLOOR(camera.y)};
+    float dx = snapped.x - cache->origin.x;
+    float dy = snapped.y - cache->origin.y;
+    set_camera(snapped);
+
+    if (cache->dirty || FABS(dx) >= width || FABS(dy) >= height) {
+        SubtreeDraw draw = {.node=node, .view=get_view_bounds()};
+        layer_draw(cache, draw_subtree, &draw);
+    } else if (dx != 0 || dy != 0) {
+        int16_t sx = dx;
+        int16_t sy = dy;
+        layer_scroll(cache, -sx, -sy);
+        if (sx > 0) render_scroll_strip(node, cache, width - sx, 0, sx, height);
+        else if (sx < 0) render_scroll_strip(node, cache, 0, 0, -sx, height);
+        if (sy > 0) render_scroll_strip(node, cache, 0, height - sy, width, sy);
+        else if (sy < 0) render_scroll_strip(node, cache, 0, 0, width, -sy);
+    }
+    cache->origin = snapped;
+    set_camera(camera);
+
+    layer_composite(cache, buffer, 0, 0);
+    return true;
+}
+
+void render() {
+    RuntimeData *runtime = runtime_data();
+    if (!runtime->root) return;
+    //changes made outside of update, e.g. by the scheduler or tweens
+    refresh_bounds(runtime->root);
+    Bounds view = get_view_bounds();
+    render_node(runtime->root, runtime->renderInstance.buffer, &view, true);
 }
 
 void set_renderer_dirty() {
-    runtimeData.dirty = true;
+    runtime_data()->dirty = true;
+}
+
+// one engine step, delta in ms
+static void run_frame(RuntimeData *runtime, EngineConfig *config, uint32_t delta) {
+    if (config->on_frame_start) {
+        config->on_frame_start(config->gameState, runtime->frame);
+    }
+
+    delta = replay_frame_begin(delta);
+    runtime->tick += delta;
+    runtime->delta_time = (float) (delta) / 1000.f;
+
+    size_t start = curr_time();
+    runtime->stats.transform = 0;
+    update();
+    if (config->profile) runtime->stats.update = elapsed_us(start) - runtime->stats.transform;
+
+    scheduler_update();
+    tweener_update();
+    update_audio();
+
+    start = curr_time();
+    buffer_clear(runtime->renderInstance.buffer);
+    if (runtime->dirty) {
+        render();
+    }
+    if (config->profile) runtime->stats.render = elapsed_us(start);
+
+    start = curr_time();
+    if (runtime->ui) ui_render(runtime->ui, runtime->renderInstance.buffer);
+    if (config->profile) runtime->stats.ui = elapsed_us(start);
+
+    replay_frame_end(runtime->renderInstance.buffer);
+
+    if (config->on_frame_end) {
+        config->on_frame_end(config->gameState, runtime->frame, runtime->renderInstance.buffer);
+    }
+    runtime->frame++;
+}
+
+// frames run back to back, the clock advances by exactly one frame each time
+static void run_headless(RuntimeData *runtime, EngineConfig *config, uint32_t frame_time) {
+    while (!runtime->exit) {
+        run_frame(runtime, config, frame_time);
+    }
 }
 
 void start_loop() {
-    furi_thread_set_current_priority(FuriThreadPriorityIdle);
-    size_t curr_frame_time = furi_get_tick();
+    EngineConfig *config = engine_config();
+    RuntimeData *runtime = runtime_data();
     //Failsafe, if 0, set it to a reasonable fps
-    if (engineConfig.render_fps == 0) engineConfig.render_fps = 20;
+    if (config->render_fps == 0) config->render_fps = 20;
+
+    const uint32_t FPS = 1000 / config->render_fps;
 
-    const uint32_t FPS = 1000 / engineConfig.render_fps;
+    if (config->headless) {
+        run_headless(runtime, config, FPS);
+        cleanup_engine();
+        return;
+    }
+
+    furi_thread_set_current_priority(FuriThreadPriorityIdle);
+    size_t curr_frame_time = furi_get_tick();
     size_t last_frame_time = curr_frame_time - FPS;
     size_t delta = 0;
 
-    while (!runtimeData.exit) {
-        if (furi_mutex_acquire(runtimeData.update_mutex, 25) != FuriStatusOk)
+    while (!runtime->exit) {
+        if (furi_mutex_acquire(runtime->update_mutex, 25) != FuriStatusOk)
             continue;
 
         curr_frame_time = furi_get_tick();
@@ -309,21 +821,9 @@ void start_loop() {
         // Timer *t = timer_start("update");
 
         //Skip processing if delta is below the set update rate
-        if (delta >= FPS) {
-            runtimeData.delta_time = (float) (delta) / 1000.f/* / 64000000.0f*/;
+        if (delta >= FPS || config->uncapped) {
             last_frame_time = curr_frame_time;
-
-            update(runtimeData.root);
-
-            scheduler_update();
-            tweener_update();
-            update_audio();
-
-            buffer_clear(runtimeData.renderInstance.buffer);
-            // t = timer_start("render");
-            if (runtimeData.dirty) {
-                render();
-            }
+            run_frame(runtime, config, delta);
         }
 
         // timer_end(t);
@@ -331,17 +831,19 @@ void start_loop() {
 
         // Draw the back buffer and UI
         // t = timer_start("xbm");
-        buffer_render(runtimeData.renderInstance.buffer, runtimeData.renderInstance.canvas);
+        size_t present_start = curr_time();
+        buffer_render(runtime->renderInstance.buffer, runtime->renderInstance.canvas);
         // timer_end(t);
 
-        if (engineConfig.render_ui) {
-            engineConfig.render_ui(engineConfig.gameState, runtimeData.renderInstance.canvas);
+        if (config->render_ui) {
+            config->render_ui(config->gameState, runtime->renderInstance.canvas);
         }
 
-        canvas_commit(runtimeData.renderInstance.canvas);
+        canvas_commit(runtime->renderInstance.canvas);
+        if (config->profile) runtime->stats.present = elapsed_us(present_start);
 
 
-        furi_mutex_release(runtimeData.update_mutex);
+        furi_mutex_release(runtime->update_mutex);
         furi_thread_yield();
     }
 
@@ -2,9 +2,17 @@
 #include <gui/canvas.h>
 #include "utils/list.h"
 #include "graphics/buffer.h"
+#include "graphics/font.h"
+#include "graphics/ui.h"
 #include "f0ge_types.h"
 #include "node.h"
 #include "component.h"
+#include "node_pool.h"
+#include "prefab.h"
+#include "scene.h"
+#include "world_stream.h"
+#include "particles.h"
+#include "context.h"
 
 void init_engine(EngineConfig config);
 void set_scene(Node *root);
@@ -16,10 +24,26 @@ void set_renderer_dirty();
 
 // calls component->end and removes the tree from the renderer
 void node_removed(Node *node);
-// same as node_removed, but also releases the lists for the components and node tree
+// same as node_removed, but also releases the node tree and the storage of the children and components
 void node_free(Node *node);
+// detaches the node from its parent and frees it with its subtree, pooled nodes go back to their pool
+void node_destroy(Node *node);
+// the draw_bounds of a custom renderer changed, the bounds are refreshed before the next render
+void node_bounds_changed(Node *node);
 
 void change_ui_renderer(void (*render_ui)(void *gameState, Canvas *canvas));
+// retained ui composited over every frame, the engine owns it and releases the previous one, NULL removes it
+void set_ui_layer(UiLayer *ui);
+UiLayer *get_ui_layer();
+
+// stops start_loop after the current frame
+void engine_exit();
+// milliseconds, the sum of the frame deltas: the same clock in every mode, replays and headless runs reproduce it
+uint32_t engine_get_tick();
+// timings of the last frame, only filled when EngineConfig.profile is set
+const FrameStats *engine_frame_stats();
+// feeds an input event like a button would, call it from the engine thread (eg. on_frame_start or a component)
+void engine_inject_input(InputKey key, InputType type);
 
 InputType get_key_state(InputKey key);
 bool is_down(InputKey key);
@@ -27,4 +51,15 @@ bool is_pressed(InputKey key);
 bool is_up(InputKey key);
 
 void add_component(Node *node, Component *component);
-void add_child(Node *parent, Node *child);
\ No newline at end of file
+void add_child(Node *parent, Node *child);
+
+// replaces the sprite of a node that is already in the scene
+void node_set_sprite(Node *node, RenderData *sprite);
+// rebakes the static subtrees containing the node, for changes the engine cannot track (eg. sprite colors)
+void node_invalidate(Node *node);
+
+// marks the transform dirty and schedules it for the next update, even if the node has no update component
+void node_set_dirty(Node *node);
+// removes the node and its subtree from the update set until node_wake is called
+void node_sleep(Node *node);
+void node_wake(Node *node);
\ No newline at end of file
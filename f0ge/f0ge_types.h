@@ -8,20 +8,37 @@ typedef struct Node Node;
 typedef struct EngineConfig EngineConfig;
 
 typedef struct Buffer Buffer;
+typedef struct UiLayer UiLayer;
 typedef struct {
     Canvas *canvas;
     Gui *gui;
     Buffer *buffer;
 } RenderInstance;
 
+// timings of the last frame in microseconds, filled when EngineConfig.profile is set
+typedef struct {
+    float update;       // components, without the transform updates
+    float transform;
+    float render;
+    float ui;           // update and composite of the retained ui layer
+    float present;      // buffer to screen and ui, always 0 in headless mode
+} FrameStats;
+
 struct EngineConfig{
     bool muted;
     bool backlight;
     uint8_t physics_fps;
     uint8_t render_fps;
-    uint8_t volume;
+    uint8_t volume;             // percent 1-100, the master volume of the music and the sound effects, 0 = unset = 100, use muted for silence
+    float lod_distance;         // nodes further than this outside the view are updated less often, 0 = disabled
+    uint8_t lod_interval;       // frames between updates of these nodes, the skipped delta is accumulated
+    bool headless;              // no gui, input or notifications, frames run back to back on a virtual clock
+    bool uncapped;              // frames are not paced by render_fps, for benchmarks
+    bool profile;               // measures every frame, see engine_frame_stats
     void *gameState;
     void (*render_ui)(void *gameState, Canvas *canvas);
+    void (*on_frame_start)(void *gameState, uint32_t frame);
+    void (*on_frame_end)(void *gameState, uint32_t frame, Buffer *buffer);
 };
 
 typedef struct {
@@ -30,12 +47,20 @@ typedef struct {
     bool muted;
     uint8_t volume;
     float delta_time;
+    uint32_t frame;
+    uint32_t tick;  // sum of the frame deltas in ms, the engine clock (engine_get_tick)
+    FrameStats stats;
     FuriPubSub *input;
     InputType inputState[6];
     FuriPubSubSubscription *input_subscription;
     FuriMutex *update_mutex;
     RenderInstance renderInstance;
     NotificationApp *notification_app;
-    List* renderers;
     Node *root;
+    UiLayer *ui;
+    //nodes that have update components or a pending transform change
+    Node *update_head;
+    Node *update_tail;
+    Node *update_cursor;
+    Node *update_current; //node whose components are running, cleared when it leaves the set
 } RuntimeData;
\ No newline at end of file
@@ -1,17 +1,17 @@
 #include "asset.h"
 #include "../utils/list.h"
 #include "../utils/helpers.h"
+#include "../context.h"
 
 typedef struct {
     const Icon *address;
     Buffer *buffer;
 } AssetIcon;
 
-static List *icons = NULL;
-
-
 Buffer *asset_load_icon(const Icon *icon) {
-    if (icons == NULL) icons = list_make();
+    EngineContext *context = engine_context_current();
+    if (context->icons == NULL) context->icons = list_make();
+    List *icons = context->icons;
 
     Buffer *data = buffer_decompress_icon(icon);
     AssetIcon *asset_icon = allocate(sizeof(AssetIcon));
@@ -22,6 +22,7 @@ Buffer *asset_load_icon(const Icon *icon) {
 }
 
 Buffer *asset_get_icon(const Icon *icon) {
+    List *icons = engine_context_current()->icons;
     if (icons != NULL) {
         ListItem *start = icons->head;
         while (start) {
@@ -37,6 +38,8 @@ Buffer *asset_get_icon(const Icon *icon) {
 }
 
 void asset_cleanup() {
+    EngineContext *context = engine_context_current();
+    List *icons = context->icons;
     if (icons == NULL) return;
     ListItem *start = icons->head;
     while (start) {
@@ -49,4 +52,5 @@ void asset_cleanup() {
         start = next;
     }
     release(icons);
+    context->icons = NULL;
 }
\ No newline at end of file
@@ -23,13 +23,16 @@ Buffer *buffer_create(uint8_t width, uint8_t height, bool double_buffered) {
     check_pointer(b);
     b->double_buffered = double_buffered;
     b->width = width;
-    b->real_width = ceil(width / 8.0);
+    b->real_width = width;
     b->height = height;
     b->data = malloc_buffer(width, height);
     check_pointer(b->data);
+    // new buffers start white, sprites drawn at runtime would pick up garbage otherwise
+    memset(b->data, 0, buffer_size(width, height));
     if (double_buffered) {
         b->back_buffer = malloc_buffer(width, height);
         check_pointer(b->back_buffer);
+        memset(b->back_buffer, 0, buffer_size(width, height));
     } else
         b->back_buffer = NULL;
     return b;
@@ -108,6 +111,124 @@ void buffer_clear(Buffer *buffer) {
     buffer->data = (uint8_t *) memset(buffer->data, 0, buffer_size(buffer->width, buffer->height));
 }
 
+void buffer_fill(Buffer *buffer, PixelColor color) {
+    check_pointer(buffer);
+    check_pointer(buffer->data);
+    memset(buffer->data, color == COLOR_BLACK ? 0xFF : 0, buffer_size(buffer->width, buffer->height));
+}
+
+void buffer_fill_span(Buffer *buffer, int16_t x0, int16_t x1, int16_t y, PixelColor color) {
+    if (y < 0 || y >= buffer->height) return;
+    x0 = MAX(x0, 0);
+    x1 = MIN(x1, buffer->width - 1);
+    if (x0 > x1) return;
+
+    uint8_t *row = &(buffer->data[y * ((buffer->width + 7) / 8)]);
+    int16_t first = x0 >> 3;
+    int16_t last = x1 >> 3;
+    uint8_t first_bits = 0xFF << (x0 & 7);
+    uint8_t last_bits = 0xFF >> (7 - (x1 & 7));
+
+    if (first == last) {
+        buffer_apply_bits(&(row[first]), first_bits & last_bits, color);
+        return;
+    }
+
+    buffer_apply_bits(&(row[first]), first_bits, color);
+    if (color == COLOR_FLIP) {
+        for (int16_t i = first + 1; i < last; i++) row[i] ^= 0xFF;
+    } else if (color == COLOR_BLACK || color == COLOR_WHITE) {
+        memset(&(row[first + 1]), color == COLOR_BLACK ? 0xFF : 0, last - first - 1);
+    }
+    buffer_apply_bits(&(row[last]), last_bits, color);
+}
+
+void buffer_fill_rect(Buffer *buffer, int16_t x, int16_t y, int16_t width, int16_t height, PixelColor color) {
+    int16_t y0 = MAX(y, 0);
+    int16_t y1 = MIN(y + height, buffer->height);
+    for (int16_t row = y0; row < y1; row++) {
+        buffer_fill_span(buffer, x, x + width - 1, row, color);
+    }
+}
+
+void buffer_scroll(Buffer *buffer, int16_t dx, int16_t dy) {
+    const int16_t stride = (buffer->width + 7) / 8;
+    const int16_t height = buffer->height;
+    uint8_t *data = buffer->data;
+
+    if (dy >= height || -dy >= height || dx >= buffer->width || -dx >= buffer->width) {
+        buffer_clear(buffer);
+        return;
+    }
+
+    // whole rows
+    if (dy > 0) {
+        memmove(&(data[dy * stride]), data, (height - dy) * stride);
+        memset(data, 0, dy * stride);
+    } else if (dy < 0) {
+        memmove(data, &(data[-dy * stride]), (height + dy) * stride);
+        memset(&(data[(height + dy) * stride]), 0, -dy * stride);
+    }
+
+    if (dx == 0) return;
+
+    // bit 0 is the leftmost pixel, so a row is a little endian bit string and moving right is a left shift
+    const int16_t bytes = (dx > 0 ? dx : -dx) >> 3;
+    const uint8_t bits = (dx > 0 ? dx : -dx) & 7;
+    for (int16_t y = 0; y < height; y++) {
+        uint8_t *row = &(data[y * stride]);
+        if (dx > 0) {
+            for (int16_t i = stride - 1; i >= 0; i--) {
+                int16_t src = i - bytes;
+                uint8_t hi = src >= 0 ? row[src] : 0;
+                uint8_t lo = src >= 1 ? row[src - 1] : 0;
+                row[i] = bits ? (hi << bits) | (lo >> (8 - bits)) : hi;
+            }
+        } else {
+            for (int16_t i = 0; i < stride; i++) {
+                int16_t src = i + bytes;
+                uint8_t lo = src < stride ? row[src] : 0;
+                uint8_t hi = src + 1 < stride ? row[src + 1] : 0;
+                row[i] = bits ? (lo >> bits) | (hi << (8 - bits)) : lo;
+            }
+        }
+    }
+}
+
+static inline void blit_byte(uint8_t *row, int16_t index, int16_t row_bytes, uint8_t bits, uint8_t mask) {
+    if (index < 0 || index >= row_bytes) return;
+    row[index] = (row[index] & ~mask) | (bits & mask);
+}
+
+void buffer_blit(Buffer *target, Buffer *source, Buffer *mask, int16_t x, int16_t y) {
+    check_pointer(target);
+    check_pointer(source);
+    const int16_t target_bytes = (target->width + 7) / 8;
+    const int16_t source_bytes = (source->width + 7) / 8;
+    //split x into a byte offset and a bit shift, works for negative positions too
+    const uint8_t shift = x & 7;
+    const int16_t offset = (x - shift) / 8;
+
+    int16_t start_row = MAX(0, -y);
+    int16_t end_row = MIN(source->height, target->height - y);
+
+    for (int16_t row = start_row; row < end_row; row++) {
+        uint8_t *dst = &(target->data[(row + y) * target_bytes]);
+        uint8_t *src = &(source->data[row * source_bytes]);
+        uint8_t *msk = mask ? &(mask->data[row * source_bytes]) : src;
+
+        for (int16_t i = 0; i < source_bytes; i++) {
+            if (shift == 0) {
+                blit_byte(dst, offset + i, target_bytes, src[i], msk[i]);
+            } else {
+                //bit 0 is the leftmost pixel, so moving right shifts the bits up
+                blit_byte(dst, offset + i, target_bytes, src[i] << shift, msk[i] << shift);
+                blit_byte(dst, offset + i + 1, target_bytes, src[i] >> (8 - shift), msk[i] >> (8 - shift));
+            }
+        }
+    }
+}
+
 void buffer_swap_with(Buffer *buffer_a, Buffer *buffer_b) {
     check_pointer(buffer_a);
     check_pointer(buffer_b);
@@ -141,6 +262,17 @@ Buffer *buffer_decompress_icon(const Icon *icon) {
     return b;
 }
 
+uint32_t buffer_checksum(Buffer *buffer) {
+    check_pointer(buffer);
+    uint32_t hash = 2166136261u;
+    const size_t size = buffer_size(buffer->width, buffer->height);
+    for (size_t i = 0; i < size; i++) {
+        hash ^= buffer->data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
 bool buffer_sample(Buffer *buffer, Vector *uv) {
     int U = FLOOR(uv->x * buffer->real_width);
     int V = FLOOR(uv->y * buffer->height);
@@ -23,6 +23,23 @@ typedef enum  {
     COLOR_SET
 } PixelColor;
 
+// applies the set bits of one buffer byte in color, the other bits are left alone
+static inline void buffer_apply_bits(uint8_t *p, uint8_t bits, PixelColor color) {
+    switch (color) {
+        case COLOR_BLACK:
+            *p |= bits;
+            break;
+        case COLOR_WHITE:
+            *p &= ~bits;
+            break;
+        case COLOR_FLIP:
+            *p ^= bits;
+            break;
+        default:
+            break;
+    }
+}
+
 #define SCREEN_WIDTH 128
 #define SCREEN_HEIGHT 64
 
@@ -51,7 +68,24 @@ void buffer_render(Buffer *buffer, Canvas *const canvas);
 
 void buffer_clear(Buffer *buffer);
 
+void buffer_fill(Buffer *buffer, PixelColor color);
+
+// fills the pixels x0..x1 (inclusive) of a row, clipped to the buffer
+void buffer_fill_span(Buffer *buffer, int16_t x0, int16_t x1, int16_t y, PixelColor color);
+
+void buffer_fill_rect(Buffer *buffer, int16_t x, int16_t y, int16_t width, int16_t height, PixelColor color);
+
+// moves the content by dx,dy pixels in place, the uncovered area is cleared
+void buffer_scroll(Buffer *buffer, int16_t dx, int16_t dy);
+
+// copies source into target at x,y, only the pixels set in mask are written (or the set pixels of source if mask is NULL)
+// source and mask widths must be multiples of 8
+void buffer_blit(Buffer *target, Buffer *source, Buffer *mask, int16_t x, int16_t y);
+
 Buffer *buffer_decompress_icon(const Icon *icon);
 bool buffer_sample(Buffer *buffer, Vector *uv);
 
+// FNV-1a hash of the pixels
+uint32_t buffer_checksum(Buffer *buffer);
+
 //if needed draw rounded box can be done by creating a new sampling for render_filled function and base it on UV
@@ -0,0 +1,237 @@
+#include "draw.h"
+#include "render.h"
+#include "../math/equation.h"
+#include "../math/fixed.h"
+#include "../math/matrix.h"
+#include "../context.h"
+
+static Matrix identity_transform = IDENTITY_MATRIX;
+
+typedef struct {
+    int16_t x0, y0, x1, y1;     // inclusive
+} DrawClip;
+
+static inline RenderState *render_state() {
+    return &(engine_context_current()->render);
+}
+
+static inline Matrix *current_transform(RenderState *state) {
+    return state->transform ? state->transform : &identity_transform;
+}
+
+// the buffer limited by set_clip, false if nothing is left
+static bool get_clip(Buffer *buffer, DrawClip *clip) {
+    return get_clip_rect(buffer, &(clip->x0), &(clip->y0), &(clip->x1), &(clip->y1));
+}
+
+static void to_screen(RenderState *state, const Vector *point, Vector *screen) {
+    matrix_mul_vector(current_transform(state), (Vector *) point, screen);
+    screen->x -= state->camera_position.x;
+    screen->y -= state->camera_position.y;
+}
+
+static inline void span(Buffer *buffer, const DrawClip *clip, int16_t x0, int16_t x1, int16_t y, PixelColor color) {
+    if (y < clip->y0 || y > clip->y1) return;
+    x0 = MAX(x0, clip->x0);
+    x1 = MIN(x1, clip->x1);
+    if (x0 <= x1) buffer_fill_span(buffer, x0, x1, y, color);
+}
+
+// Liang-Barsky, shortens the segment to the part inside the clip, false if none of it is
+static bool clip_segment(Vector *a, Vector *b, const DrawClip *clip) {
+    const float dx = b->x - a->x;
+    const float dy = b->y - a->y;
+    //pixels cover [x, x + 1), stay just below the right and bottom edges so they floor inside
+    const float p[4] = {-dx, dx, -dy, dy};
+    const float q[4] = {a->x - clip->x0, clip->x1 + 0.999f - a->x, a->y - clip->y0, clip->y1 + 0.999f - a->y};
+    float t0 = 0, t1 = 1;
+    for (uint8_t i = 0; i < 4; i++) {
+        if (p[i] == 0) {
+            if (q[i] < 0) return false;
+            continue;
+        }
+        const float t = q[i] / p[i];
+        if (p[i] < 0) {
+            if (t > t1) return false;
+            t0 = MAX(t0, t);
+        } else {
+            if (t < t0) return false;
+            t1 = MIN(t1, t);
+        }
+    }
+    *b = (Vector) {a->x + t1 * dx, a->y + t1 * dy};
+    *a = (Vector) {a->x + t0 * dx, a->y + t0 * dy};
+    return true;
+}
+
+// Bresenham between two pixels inside the clip, pixels on the same row are written as one span
+static void step_line(Buffer *buffer, int16_t x0, int16_t y0, int16_t x1, int16_t y1, PixelColor color) {
+    const int16_t dx = abs(x1 - x0);
+    const int16_t dy = -abs(y1 - y0);
+    const int16_t sx = x0 < x1 ? 1 : -1;
+    const int16_t sy = y0 < y1 ? 1 : -1;
+    int16_t err = dx + dy;
+    int16_t run = x0;
+
+    while (true) {
+        if (x0 == x1 && y0 == y1) break;
+        const int16_t e2 = 2 * err;
+        int16_t x = x0, y = y0;
+        if (e2 >= dy) {
+            err += dy;
+            x += sx;
+        }
+        if (e2 <= dx) {
+            err += dx;
+            y += sy;
+        }
+        if (y != y0) {
+            buffer_fill_span(buffer, MIN(run, x0), MAX(run, x0), y0, color);
+            run = x;
+        }
+        x0 = x;
+        y0 = y;
+    }
+    buffer_fill_span(buffer, MIN(run, x0), MAX(run, x0), y0, color);
+}
+
+static void line_screen(Buffer *buffer, const DrawClip *clip, Vector a, Vector b, PixelColor color) {
+    if (!clip_segment(&a, &b, clip)) return;
+    step_line(buffer, FLOOR(a.x), FLOOR(a.y), FLOOR(b.x), FLOOR(b.y), color);
+}
+
+void draw_line(Buffer *buffer, Vector *a, Vector *b) {
+    DrawClip clip;
+    if (!get_clip(buffer, &clip)) return;
+    RenderState *state = render_state();
+    Vector sa, sb;
+    to_screen(state, a, &sa);
+    to_screen(state, b, &sb);
+    line_screen(buffer, &clip, sa, sb, state->color);
+}
+
+void draw_polyline(Buffer *buffer, const Vector *points, uint8_t count, bool closed) {
+    DrawClip clip;
+    if (count < 2 || !get_clip(buffer, &clip)) return;
+    RenderState *state = render_state();
+    Vector first, previous, current;
+    to_screen(state, &(points[0]), &first);
+    previous = first;
+    for (uint8_t i = 1; i < count; i++) {
+        to_screen(state, &(points[i]), &current);
+        line_screen(buffer, &clip, previous, current, state->color);
+        previous = current;
+    }
+    if (closed && count > 2) line_screen(buffer, &clip, previous, first, state->color);
+}
+
+// Midpoint style ellipse walked one row at a time from the middle outwards: the half width only shrinks,
+// so each row costs a few integer steps. A pixel is inside when its center is in the ellipse of radius r + 0.5.
+// Outlines cover the part of a row that the next row does not, which keeps them closed without double pixels.
+static void ellipse_screen(Buffer *buffer, const DrawClip *clip, int16_t cx, int16_t cy, int16_t rx, int16_t ry,
+                           bool filled, PixelColor color) {
+    if (rx < 0 || ry < 0) return;
+    if (cx + rx < clip->x0 || cx - rx > clip->x1 || cy + ry < clip->y0 || cy - ry > clip->y1) return;
+
+    //everything is doubled to stay in integers: (2x)^2 (2ry+1)^2 + (2y)^2 (2rx+1)^2 <= (2rx+1)^2 (2ry+1)^2
+    const int64_t a2 = (int64_t) (2 * rx + 1) * (2 * rx + 1);
+    const int64_t b2 = (int64_t) (2 * ry + 1) * (2 * ry + 1);
+    const int64_t limit = a2 * b2;
+    int16_t x = rx;
+    for (int16_t y = 0; y <= ry; y++) {
+        while (x > 0 && 4 * x * x * b2 + 4 * y * y * a2 > limit) x--;
+        //rows of the top and bottom half outside the clip can be skipped as a pair
+        if (cy + y < clip->y0 && cy - y < clip->y0) continue;
+        if (cy - y > clip->y1 && cy + y > clip->y1) break;
+
+        int16_t inner = 0;
+        if (!filled && y < ry) {
+            int16_t next = x;
+            while (next > 0 && 4 * next * next * b2 + 4 * (y + 1) * (y + 1) * a2 > limit) next--;
+            inner = MIN(next + 1, x);
+        }
+        if (inner == 0) {
+            span(buffer, clip, cx - x, cx + x, cy + y, color);
+            if (y > 0) span(buffer, clip, cx - x, cx + x, cy - y, color);
+        } else {
+            span(buffer, clip, cx - x, cx - inner, cy + y, color);
+            span(buffer, clip, cx + inner, cx + x, cy + y, color);
+            if (y > 0) {
+                span(buffer, clip, cx - x, cx - inner, cy - y, color);
+                span(buffer, clip, cx + inner, cx + x, cy - y, color);
+            }
+        }
+    }
+}
+
+void draw_ellipse(Buffer *buffer, Vector *center, float radius_x, float radius_y, bool filled) {
+    DrawClip clip;
+    if (!get_clip(buffer, &clip)) return;
+    RenderState *state = render_state();
+    Vector screen;
+    to_screen(state, center, &screen);
+    ellipse_screen(buffer, &clip, FLOOR(screen.x), FLOOR(screen.y), roundf(radius_x), roundf(radius_y), filled,
+                   state->color);
+}
+
+void draw_circle(Buffer *buffer, Vector *center, float radius, bool filled) {
+    Vector scale;
+    matrix_get_scaling(current_transform(render_state()), &scale);
+    draw_ellipse(buffer, center, radius * scale.x, radius * scale.y, filled);
+}
+
+// rounds towards +infinity, the divisor is positive
+static inline int32_t ceil_div(int64_t value, int64_t divisor) {
+    return (int32_t) (value >= 0 ? (value + divisor - 1) / divisor : -(-value / divisor));
+}
+
+// Pixels whose center is inside, rows and columns are half open so neighbouring polygons do not overlap.
+// The vertices are snapped like the mesh rasterizer does it and every row crossing is one exact division,
+// so a polygon and a mesh of the same outline cover the same pixels in both builds.
+static void fill_polygon(Buffer *buffer, const DrawClip *clip, const Vector *screen, uint8_t count, PixelColor color) {
+    const int32_t one = FX_SUBPIXEL_ONE;
+    int32_t x[DRAW_MAX_VERTICES], y[DRAW_MAX_VERTICES];
+    int32_t top = INT32_MAX, bottom = INT32_MIN;
+    for (uint8_t i = 0; i < count; i++) {
+        x[i] = fx_subpixel(screen[i].x);
+        y[i] = fx_subpixel(screen[i].y);
+        top = MIN(top, y[i]);
+        bottom = MAX(bottom, y[i]);
+    }
+
+    const int16_t y0 = MAX(clip->y0, ceil_div(top - one / 2, one));
+    const int16_t y1 = MIN(clip->y1, ceil_div(bottom - one / 2, one) - 1);
+    for (int16_t row = y0; row <= y1; row++) {
+        const int32_t sample = row * one + one / 2;
+        int32_t left = INT32_MAX, right = INT32_MIN;
+        for (uint8_t i = 0; i < count; i++) {
+            const uint8_t j = (i + 1) % count;
+            //edges point downwards, the crossing is at numerator / dy
+            const uint8_t a = y[i] < y[j] ? i : j, b = y[i] < y[j] ? j : i;
+            if (y[a] > sample || sample >= y[b]) continue;
+            const int64_t dy = y[b] - y[a];
+            const int64_t numerator = (int64_t) x[a] * dy + (int64_t) (sample - y[a]) * (x[b] - x[a]);
+            //first column whose center is at or right of the crossing
+            const int32_t column = ceil_div(numerator - dy * (one / 2), dy * one);
+            left = MIN(left, column);
+            right = MAX(right, column);
+        }
+        if (left > right) continue;
+        span(buffer, clip, MAX(left, INT16_MIN), MIN(right - 1, INT16_MAX), row, color);
+    }
+}
+
+void draw_polygon(Buffer *buffer, const Vector *points, uint8_t count, bool filled) {
+    if (!filled) {
+        draw_polyline(buffer, points, count, true);
+        return;
+    }
+    DrawClip clip;
+    if (count < 3 || !get_clip(buffer, &clip)) return;
+    count = MIN(count, DRAW_MAX_VERTICES);
+
+    RenderState *state = render_state();
+    Vector screen[DRAW_MAX_VERTICES];
+    for (uint8_t i = 0; i < count; i++) to_screen(state, &(points[i]), &(screen[i]));
+    fill_polygon(buffer, &clip, screen, count, state->color);
+}
@@ -0,0 +1,25 @@
+#pragma once
+#include "buffer.h"
+#include "../math/vector.h"
+
+// Vector shapes for hud gauges, debug overlays and procedural graphics.
+// Points go through the current transform (set_transform) and the camera like sprites do, the color comes from
+// set_color. Everything is clipped to the buffer and set_clip before any pixel is stepped,
+// horizontal runs are written as byte spans.
+
+// most vertices of a polygon
+#define DRAW_MAX_VERTICES 16
+
+void draw_line(Buffer *buffer, Vector *a, Vector *b);
+
+// closed connects the last point to the first one
+void draw_polyline(Buffer *buffer, const Vector *points, uint8_t count, bool closed);
+
+// the radius is scaled by the transform, a non uniform scale gives an axis aligned ellipse
+void draw_circle(Buffer *buffer, Vector *center, float radius, bool filled);
+
+// axis aligned in screen space, the rotation of the transform only moves the center
+void draw_ellipse(Buffer *buffer, Vector *center, float radius_x, float radius_y, bool filled);
+
+// filled polygons have to be convex, either winding works
+void draw_polygon(Buffer *buffer, const Vector *points, uint8_t count, bool filled);
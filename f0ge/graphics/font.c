@@ -0,0 +1,169 @@
+#include "font.h"
+#include "../context.h"
+
+static inline FontState *font_state() {
+    return &(engine_context_current()->fonts);
+}
+
+static const FontGlyph *find_glyph(const Font *font, uint8_t c) {
+    if (font->uppercase_only && c >= 'a' && c <= 'z') c -= 'a' - 'A';
+    if (c < font->first || c > font->last) return NULL;
+    return &(font->glyphs[c - font->first]);
+}
+
+static int8_t kerning(const Font *font, uint8_t left, uint8_t right) {
+    if (font->kerning_count == 0) return 0;
+    if (font->uppercase_only) {
+        if (left >= 'a' && left <= 'z') left -= 'a' - 'A';
+        if (right >= 'a' && right <= 'z') right -= 'a' - 'A';
+    }
+    const uint16_t pair = (left << 8) | right;
+    int16_t low = 0, high = font->kerning_count - 1;
+    while (low <= high) {
+        int16_t mid = (low + high) / 2;
+        if (font->kerning[mid].pair == pair) return font->kerning[mid].adjust;
+        if (font->kerning[mid].pair < pair) low = mid + 1;
+        else high = mid - 1;
+    }
+    return 0;
+}
+
+static void draw_glyph(Buffer *target, const Font *font, const FontGlyph *glyph, int16_t x, int16_t y,
+                       PixelColor color) {
+    const int16_t target_bytes = (target->width + 7) / 8;
+    const int16_t glyph_bytes = (glyph->width + 7) / 8;
+    x += glyph->x_offset;
+    y += glyph->y_offset;
+    //split x into a byte offset and a bit shift, works for negative positions too
+    const uint8_t shift = x & 7;
+    const int16_t offset = (x - shift) / 8;
+
+    const int16_t start_row = MAX(0, -y);
+    const int16_t end_row = MIN(glyph->height, target->height - y);
+    const uint8_t *bitmap = &(font->bitmaps[glyph->offset]);
+    for (int16_t row = start_row; row < end_row; row++) {
+        uint8_t *dst = &(target->data[(row + y) * target_bytes]);
+        const uint8_t *src = &(bitmap[row * glyph_bytes]);
+        for (int16_t i = 0; i < glyph_bytes; i++) {
+            const int16_t index = offset + i;
+            //bit 0 is the leftmost pixel, so moving right shifts the bits up
+            if (index >= 0 && index < target_bytes) buffer_apply_bits(&(dst[index]), src[i] << shift, color);
+            if (shift && index + 1 >= 0 && index + 1 < target_bytes) {
+                buffer_apply_bits(&(dst[index + 1]), src[i] >> (8 - shift), color);
+            }
+        }
+    }
+}
+
+int16_t font_draw_text(Buffer *target, const Font *font, const char *text, int16_t x, int16_t y, PixelColor color) {
+    int16_t pen = x;
+    for (const uint8_t *c = (const uint8_t *) text; *c; c++) {
+        if (*c == '\n') {
+            pen = x;
+            y += font->line_height;
+            continue;
+        }
+        const FontGlyph *glyph = find_glyph(font, *c);
+        if (!glyph) continue;
+        //glyphs completely outside of the target are only advanced over
+        if (pen < target->width && pen + glyph->x_offset + glyph->width > 0 && glyph->height > 0) {
+            draw_glyph(target, font, glyph, pen, y, color);
+        }
+        pen += glyph->advance + kerning(font, c[0], c[1]);
+    }
+    return pen;
+}
+
+uint16_t font_measure(const Font *font, const char *text) {
+    int16_t width = 0, line = 0;
+    for (const uint8_t *c = (const uint8_t *) text; *c; c++) {
+        if (*c == '\n') {
+            width = MAX(width, line);
+            line = 0;
+            continue;
+        }
+        const FontGlyph *glyph = find_glyph(font, *c);
+        if (!glyph) continue;
+        line += glyph->advance + kerning(font, c[0], c[1]);
+    }
+    return MAX(width, line);
+}
+
+uint16_t font_measure_cached(const Font *font, const char *text) {
+    FontState *state = font_state();
+    for (uint8_t i = 0; i < FONT_MEASURE_CACHE_SIZE; i++) {
+        FontMeasure *measure = &(state->measures[i]);
+        if (measure->text == text && measure->font == font) return measure->width;
+    }
+    FontMeasure *measure = &(state->measures[state->next]);
+    state->next = (state->next + 1) % FONT_MEASURE_CACHE_SIZE;
+    measure->font = font;
+    measure->text = text;
+    measure->width = font_measure(font, text);
+    return measure->width;
+}
+
+void font_draw_label(Buffer *target, const Font *font, const char *text, int16_t x, int16_t y, TextAlign align,
+                     PixelColor color) {
+    if (align != AlignLeft) {
+        const uint16_t width = font_measure_cached(font, text);
+        x -= align == AlignCenter ? width / 2 : width;
+    }
+    font_draw_text(target, font, text, x, y, color);
+}
+
+static uint8_t counter_cell_width(FontCounter *counter) {
+    if (counter->cell_width) return counter->cell_width;
+    const char *cells = "0123456789-";
+    for (const char *c = cells; *c; c++) {
+        const FontGlyph *glyph = find_glyph(counter->font, *c);
+        if (glyph) counter->cell_width = MAX(counter->cell_width, glyph->advance);
+    }
+    return counter->cell_width;
+}
+
+static void draw_cell(Buffer *target, FontCounter *counter, int16_t x, char c) {
+    const FontGlyph *glyph = find_glyph(counter->font, c);
+    if (!glyph || c == ' ') return;
+    //digits are centered in their cell so narrow ones do not wobble
+    draw_glyph(target, counter->font, glyph, x + (counter->cell_width - glyph->advance) / 2, counter->y,
+               counter->color);
+}
+
+uint8_t font_counter_draw(Buffer *target, FontCounter *counter, int32_t value) {
+    const uint8_t digits = MIN(counter->digits, FONT_COUNTER_DIGITS);
+    const uint8_t cell_width = counter_cell_width(counter);
+
+    //right aligned text of the value, blank padded
+    char text[FONT_COUNTER_DIGITS];
+    uint32_t magnitude = value < 0 ? -(uint32_t) value : (uint32_t) value;
+    int8_t i = digits - 1;
+    do {
+        text[i--] = '0' + magnitude % 10;
+        magnitude /= 10;
+    } while (magnitude && i >= 0);
+    if (value < 0 && i >= 0) text[i--] = '-';
+    while (i >= 0) text[i--] = ' ';
+
+    uint8_t redrawn = 0;
+    for (uint8_t cell = 0; cell < digits; cell++) {
+        const char old = counter->shown[cell];
+        if (old == text[cell]) continue;
+        const int16_t x = counter->x - (digits - cell) * cell_width;
+        if (counter->color == COLOR_FLIP) {
+            //flipping the old glyph again erases it
+            if (old) draw_cell(target, counter, x, old);
+        } else {
+            buffer_fill_rect(target, x, counter->y, cell_width, counter->font->height,
+                             counter->color == COLOR_BLACK ? COLOR_WHITE : COLOR_BLACK);
+        }
+        draw_cell(target, counter, x, text[cell]);
+        counter->shown[cell] = text[cell];
+        redrawn++;
+    }
+    return redrawn;
+}
+
+void font_counter_invalidate(FontCounter *counter) {
+    memset(counter->shown, 0, sizeof(counter->shown));
+}
@@ -0,0 +1,103 @@
+#pragma once
+#include <furi.h>
+#include "buffer.h"
+
+// 1-bit bitmap fonts drawn straight into a Buffer, a glyph row is blitted a byte at a time.
+// Fonts are const data made by tools/font/font_convert.py, see font_3x5 for the built-in one.
+// Glyph rows use the Buffer layout: (width + 7) / 8 bytes per row, bit 0 is the leftmost pixel.
+
+typedef struct {
+    uint16_t offset;    // of the first row in Font.bitmaps
+    uint8_t width;
+    uint8_t height;
+    int8_t x_offset;    // from the pen position
+    uint8_t y_offset;   // from the top of the line, empty rows are not stored
+    uint8_t advance;    // pen movement after the glyph
+} FontGlyph;
+
+typedef struct {
+    uint16_t pair;      // left << 8 | right, the table is sorted by it
+    int8_t adjust;      // added to the advance of the left glyph
+} FontKerning;
+
+typedef struct {
+    uint8_t height;
+    uint8_t line_height;
+    uint8_t first;      // character of glyphs[0]
+    uint8_t last;
+    bool uppercase_only; // lowercase text is drawn with the uppercase glyphs
+    const FontGlyph *glyphs;
+    const uint8_t *bitmaps;
+    const FontKerning *kerning;
+    uint16_t kerning_count;
+} Font;
+
+typedef enum {
+    AlignLeft,
+    AlignCenter,
+    AlignRight,
+} TextAlign;
+
+// widths of recently measured strings, keyed by the string address (for labels that never change)
+#define FONT_MEASURE_CACHE_SIZE 8
+
+typedef struct {
+    const Font *font;
+    const char *text;
+    uint16_t width;
+} FontMeasure;
+
+// per engine context state of the text renderer
+typedef struct {
+    FontMeasure measures[FONT_MEASURE_CACHE_SIZE];
+    uint8_t next;
+} FontState;
+
+#define DEFAULT_FONT_STATE { \
+    .next=0 \
+}
+
+extern const Font font_3x5;
+
+// draws text with its top left corner at x,y, '\n' starts a new line, returns the pen x at the end
+int16_t font_draw_text(Buffer *target, const Font *font, const char *text, int16_t x, int16_t y, PixelColor color);
+
+// x is the left edge, the center or the right edge of the text depending on align
+// the width comes from the measure cache, the text must not change while its address stays the same
+void font_draw_label(Buffer *target, const Font *font, const char *text, int16_t x, int16_t y, TextAlign align,
+                     PixelColor color);
+
+// width of the longest line in pixels
+uint16_t font_measure(const Font *font, const char *text);
+
+uint16_t font_measure_cached(const Font *font, const char *text);
+
+// A right aligned number that only redraws the digits that changed since the last draw.
+// Meant for buffers that are kept between frames (eg. a HUD layer), the cells are cleared with the opposite color.
+#define FONT_COUNTER_DIGITS 11
+
+typedef struct {
+    const Font *font;
+    int16_t x;          // right edge
+    int16_t y;
+    uint8_t digits;     // cells, up to FONT_COUNTER_DIGITS
+    PixelColor color;
+    uint8_t cell_width; // widest digit, measured on the first draw
+    char shown[FONT_COUNTER_DIGITS];
+} FontCounter;
+
+#define MAKE_FONT_COUNTER(counter_font, right, top, cells) (FontCounter){ \
+    .font=counter_font, \
+    .x=right, \
+    .y=top, \
+    .digits=cells, \
+    .color=COLOR_BLACK, \
+    .cell_width=0, \
+    .shown={0} \
+}
+
+// returns the number of redrawn cells
+uint8_t font_counter_draw(Buffer *target, FontCounter *counter, int32_t value);
+
+// the next draw redraws every cell, eg. after the buffer was cleared
+void font_counter_invalidate(FontCounter *counter);
@@ -0,0 +1,120 @@
+// generated by tools/font/font_convert.py, do not edit
+#include "font.h"
+
+static const uint8_t font_3x5_bitmaps[] = {
+    0x01, 0x01, 0x01, 0x00, 0x01, 0x05, 0x05, 0x05, 0x07, 0x05, 0x07, 0x05,
+    0x05, 0x04, 0x02, 0x01, 0x05, 0x01, 0x01, 0x02, 0x01, 0x01, 0x01, 0x02,
+    0x01, 0x02, 0x02, 0x02, 0x01, 0x05, 0x02, 0x05, 0x02, 0x07, 0x02, 0x01,
+    0x01, 0x07, 0x01, 0x04, 0x04, 0x02, 0x01, 0x01, 0x07, 0x05, 0x05, 0x05,
+    0x07, 0x02, 0x03, 0x02, 0x02, 0x07, 0x07, 0x04, 0x07, 0x01, 0x07, 0x07,
+    0x04, 0x06, 0x04, 0x07, 0x05, 0x05, 0x07, 0x04, 0x04, 0x07, 0x01, 0x07,
+    0x04, 0x07, 0x07, 0x01, 0x07, 0x05, 0x07, 0x07, 0x04, 0x02, 0x02, 0x02,
+    0x07, 0x05, 0x07, 0x05, 0x07, 0x07, 0x05, 0x07, 0x04, 0x07, 0x01, 0x00,
+    0x01, 0x04, 0x02, 0x01, 0x02, 0x04, 0x07, 0x00, 0x07, 0x01, 0x02, 0x04,
+    0x02, 0x01, 0x07, 0x04, 0x06, 0x00, 0x02, 0x02, 0x05, 0x07, 0x05, 0x05,
+    0x03, 0x05, 0x03, 0x05, 0x03, 0x06, 0x01, 0x01, 0x01, 0x06, 0x03, 0x05,
+    0x05, 0x05, 0x03, 0x07, 0x01, 0x03, 0x01, 0x07, 0x07, 0x01, 0x03, 0x01,
+    0x01, 0x06, 0x01, 0x05, 0x05, 0x06, 0x05, 0x05, 0x07, 0x05, 0x05, 0x07,
+    0x02, 0x02, 0x02, 0x07, 0x04, 0x04, 0x04, 0x05, 0x02, 0x05, 0x05, 0x03,
+    0x05, 0x05, 0x01, 0x01, 0x01, 0x01, 0x07, 0x05, 0x07, 0x07, 0x05, 0x05,
+    0x03, 0x05, 0x05, 0x05, 0x05, 0x02, 0x05, 0x05, 0x05, 0x02, 0x03, 0x05,
+    0x03, 0x01, 0x01, 0x02, 0x05, 0x05, 0x03, 0x06, 0x03, 0x05, 0x03, 0x05,
+    0x05, 0x06, 0x01, 0x02, 0x04, 0x03, 0x07, 0x02, 0x02, 0x02, 0x02, 0x05,
+    0x05, 0x05, 0x05, 0x07, 0x05, 0x05, 0x05, 0x05, 0x02, 0x05, 0x05, 0x07,
+    0x07, 0x05, 0x05, 0x05, 0x02, 0x05, 0x05, 0x05, 0x05, 0x02, 0x02, 0x02,
+    0x07, 0x04, 0x02, 0x01, 0x07, 0x03, 0x01, 0x01, 0x01, 0x03, 0x03, 0x02,
+    0x02, 0x02, 0x03, 0x07,
+};
+
+static const FontGlyph font_3x5_glyphs[] = {
+    {0, 0, 0, 0, 0, 3}, // 32
+    {0, 1, 5, 0, 0, 2}, // !
+    {5, 3, 2, 0, 0, 4}, // "
+    {7, 3, 5, 0, 0, 4}, // #
+    {0, 0, 0, 0, 0, 0}, // $
+    {12, 3, 5, 0, 0, 4}, // %
+    {0, 0, 0, 0, 0, 0}, // &
+    {17, 1, 2, 0, 0, 2}, // '
+    {19, 2, 5, 0, 0, 3}, // (
+    {24, 2, 5, 0, 0, 3}, // )
+    {29, 3, 3, 0, 1, 4}, // *
+    {32, 3, 3, 0, 1, 4}, // +
+    {35, 1, 2, 0, 3, 2}, // ,
+    {37, 3, 1, 0, 2, 4}, // -
+    {38, 1, 1, 0, 4, 2}, // .
+    {39, 3, 5, 0, 0, 4}, // /
+    {44, 3, 5, 0, 0, 4}, // 0
+    {49, 3, 5, 0, 0, 4}, // 1
+    {54, 3, 5, 0, 0, 4}, // 2
+    {59, 3, 5, 0, 0, 4}, // 3
+    {64, 3, 5, 0, 0, 4}, // 4
+    {69, 3, 5, 0, 0, 4}, // 5
+    {74, 3, 5, 0, 0, 4}, // 6
+    {79, 3, 5, 0, 0, 4}, // 7
+    {84, 3, 5, 0, 0, 4}, // 8
+    {89, 3, 5, 0, 0, 4}, // 9
+    {94, 1, 3, 0, 1, 2}, // :
+    {0, 0, 0, 0, 0, 0}, // ;
+    {97, 3, 5, 0, 0, 4}, // <
+    {102, 3, 3, 0, 1, 4}, // =
+    {105, 3, 5, 0, 0, 4}, // >
+    {110, 3, 5, 0, 0, 4}, // ?
+    {0, 0, 0, 0, 0, 0}, // @
+    {115, 3, 5, 0, 0, 4}, // A
+    {120, 3, 5, 0, 0, 4}, // B
+    {125, 3, 5, 0, 0, 4}, // C
+    {130, 3, 5, 0, 0, 4}, // D
+    {135, 3, 5, 0, 0, 4}, // E
+    {140, 3, 5, 0, 0, 4}, // F
+    {145, 3, 5, 0, 0, 4}, // G
+    {150, 3, 5, 0, 0, 4}, // H
+    {155, 3, 5, 0, 0, 4}, // I
+    {160, 3, 5, 0, 0, 4}, // J
+    {165, 3, 5, 0, 0, 4}, // K
+    {170, 3, 5, 0, 0, 4}, // L
+    {175, 3, 5, 0, 0, 4}, // M
+    {180, 3, 5, 0, 0, 4}, // N
+    {185, 3, 5, 0, 0, 4}, // O
+    {190, 3, 5, 0, 0, 4}, // P
+    {195, 3, 5, 0, 0, 4}, // Q
+    {200, 3, 5, 0, 0, 4}, // R
+    {205, 3, 5, 0, 0, 4}, // S
+    {210, 3, 5, 0, 0, 4}, // T
+    {215, 3, 5, 0, 0, 4}, // U
+    {220, 3, 5, 0, 0, 4}, // V
+    {225, 3, 5, 0, 0, 4}, // W
+    {230, 3, 5, 0, 0, 4}, // X
+    {235, 3, 5, 0, 0, 4}, // Y
+    {240, 3, 5, 0, 0, 4}, // Z
+    {245, 2, 5, 0, 0, 3}, // [
+    {0, 0, 0, 0, 0, 0}, // 92
+    {250, 2, 5, 0, 0, 3}, // ]
+    {0, 0, 0, 0, 0, 0}, // ^
+    {255, 3, 1, 0, 4, 4}, // _
+};
+
+static const FontKerning font_3x5_kerning[] = {
+    {0x4154, -1}, // AT
+    {0x4156, -1}, // AV
+    {0x4159, -1}, // AY
+    {0x4641, -1}, // FA
+    {0x4C54, -1}, // LT
+    {0x4C56, -1}, // LV
+    {0x5041, -1}, // PA
+    {0x542E, -1}, // T.
+    {0x5441, -1}, // TA
+    {0x5641, -1}, // VA
+    {0x5941, -1}, // YA
+};
+
+const Font font_3x5 = {
+    .height=5,
+    .line_height=6,
+    .first=32,
+    .last=95,
+    .uppercase_only=true,
+    .glyphs=font_3x5_glyphs,
+    .bitmaps=font_3x5_bitmaps,
+    .kerning=font_3x5_kerning,
+    .kerning_count=11,
+};
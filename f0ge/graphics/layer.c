@@ -0,0 +1,65 @@
+#include "layer.h"
+#include "../utils/helpers.h"
+
+LayerCache *layer_create(uint8_t width, uint8_t height) {
+    LayerCache *layer = allocate(sizeof(LayerCache));
+    check_pointer(layer);
+    layer->color = buffer_create(width, height, false);
+    layer->mask = buffer_create(width, height, false);
+    layer->origin = VECTOR_ZERO;
+    layer->dirty = true;
+    return layer;
+}
+
+void layer_release(LayerCache *layer) {
+    if (!layer) return;
+    buffer_release(layer->color);
+    buffer_release(layer->mask);
+    release(layer);
+}
+
+void layer_draw(LayerCache *layer, void (*draw)(Buffer *target, void *context), void *context) {
+    layer_draw_area(layer, 0, 0, layer->color->width, layer->color->height, draw, context);
+    layer->dirty = false;
+}
+
+void layer_draw_area(LayerCache *layer, int16_t x, int16_t y, int16_t width, int16_t height,
+                     void (*draw)(Buffer *target, void *context), void *context) {
+    x = MAX(x, 0);
+    y = MAX(y, 0);
+    width = MIN(width, layer->color->width - x);
+    height = MIN(height, layer->color->height - y);
+    if (width <= 0 || height <= 0) return;
+
+    // Draw once over white and once over black, untouched pixels keep the background
+    // so the difference of the two passes gives the coverage mask:
+    //   untouched: 0/1, black: 1/1, white: 0/0, flipped: 1/0
+    buffer_fill_rect(layer->color, x, y, width, height, COLOR_WHITE);
+    buffer_fill_rect(layer->mask, x, y, width, height, COLOR_BLACK);
+    draw(layer->color, context);
+    draw(layer->mask, context);
+
+    const int16_t stride = (layer->color->width + 7) / 8;
+    const int16_t first = x >> 3;
+    const int16_t last = (x + width - 1) >> 3;
+    for (int16_t row = y; row < y + height; row++) {
+        uint8_t *color = &(layer->color->data[row * stride]);
+        uint8_t *mask = &(layer->mask->data[row * stride]);
+        for (int16_t i = first; i <= last; i++) {
+            //only touch the bits inside the area, the rest already holds a finished mask
+            uint8_t area = 0xFF;
+            if (i == first) area &= 0xFF << (x & 7);
+            if (i == last) area &= 0xFF >> (7 - ((x + width - 1) & 7));
+            mask[i] = (mask[i] & ~area) | ((color[i] | ~mask[i]) & area);
+        }
+    }
+}
+
+void layer_scroll(LayerCache *layer, int16_t dx, int16_t dy) {
+    buffer_scroll(layer->color, dx, dy);
+    buffer_scroll(layer->mask, dx, dy);
+}
+
+void layer_composite(LayerCache *layer, Buffer *target, int16_t x, int16_t y) {
+    buffer_blit(target, layer->color, layer->mask, x, y);
+}
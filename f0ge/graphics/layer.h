@@ -0,0 +1,35 @@
+#pragma once
+#include "buffer.h"
+#include "../math/vector.h"
+
+// largest layer side in pixels, buffer_create takes 8 bit sizes
+#define LAYER_MAX_SIZE 248
+
+typedef struct LayerCache LayerCache;
+
+// offscreen render target that remembers which pixels were drawn, so it can be composited over other content.
+// Pixels are either untouched or opaque: a COLOR_FLIP pixel is baked as black and does not invert what is under
+// the layer later. Static and scroll subtrees with sprites in COLOR_FLIP (color or mask_color) are therefore
+// rendered directly. render_filled takes set_color at draw time, keep it out of cached subtrees if that flips.
+struct LayerCache {
+    Buffer *color;
+    Buffer *mask;   // pixels written while drawing the layer
+    Vector origin;  // world position of the top left pixel
+    bool dirty;
+};
+
+LayerCache *layer_create(uint8_t width, uint8_t height);
+
+void layer_release(LayerCache *layer);
+
+// redraws the layer with the draw callback, draw can be called multiple times
+void layer_draw(LayerCache *layer, void (*draw)(Buffer *target, void *context), void *context);
+
+// same as layer_draw, but only the pixels inside the area are replaced, draw should be clipped to it
+void layer_draw_area(LayerCache *layer, int16_t x, int16_t y, int16_t width, int16_t height,
+                     void (*draw)(Buffer *target, void *context), void *context);
+
+// moves the cached pixels, the uncovered area has to be redrawn with layer_draw_area
+void layer_scroll(LayerCache *layer, int16_t dx, int16_t dy);
+
+void layer_composite(LayerCache *layer, Buffer *target, int16_t x, int16_t y);
@@ -0,0 +1,87 @@
+#include "mode7.h"
+#include "render.h"
+#include "../math/equation.h"
+
+#define FIXED_ONE 65536.0f
+
+void mode7_prepare(Mode7 *mode7) {
+    for (uint8_t y = 0; y < SCREEN_HEIGHT; y++) {
+        if (y < mode7->horizon) {
+            mode7->_row_distance[y] = 0;
+            mode7->_row_step[y] = 0;
+            continue;
+        }
+        // distance of the floor seen through this row, the +1 keeps the first row finite
+        float distance = mode7->height * mode7->focal / (float) (y - mode7->horizon + 1);
+        mode7->_row_distance[y] = (int32_t) (distance * mode7->scale * FIXED_ONE);
+        mode7->_row_step[y] = (int32_t) (distance / mode7->focal * mode7->scale * FIXED_ONE);
+    }
+}
+
+void mode7_render(Buffer *buffer, Mode7 *mode7, Vector *position, float rotation) {
+    Buffer *texture = mode7->texture;
+    if (!buffer || !texture) return;
+
+    const uint16_t tex_width = texture->width;
+    const uint16_t tex_height = texture->height;
+    const uint16_t tex_stride = (tex_width + 7) / 8;
+    const bool pow2 = (tex_width & (tex_width - 1)) == 0 && (tex_height & (tex_height - 1)) == 0;
+    const uint8_t *tex = texture->data;
+
+    const uint16_t stride = (buffer->width + 7) / 8;
+    const uint8_t invert = mode7->color == COLOR_WHITE ? 0xFF : 0;
+
+    // forward points up on screen at 0 degrees, same as the sprites
+    const float rad = rotation * DEG_2_RAD;
+    const int32_t fx = (int32_t) (sinf(rad) * FIXED_ONE);
+    const int32_t fy = (int32_t) (-cosf(rad) * FIXED_ONE);
+    const int32_t rx = -fy;
+    const int32_t ry = fx;
+
+    const int32_t pos_u = (int32_t) (position->x * mode7->scale * FIXED_ONE);
+    const int32_t pos_v = (int32_t) (position->y * mode7->scale * FIXED_ONE);
+    const int32_t half_width = buffer->width / 2;
+
+    for (uint16_t y = mode7->horizon; y < buffer->height && y < SCREEN_HEIGHT; y++) {
+        const int32_t distance = mode7->_row_distance[y];
+        const int32_t step = mode7->_row_step[y];
+
+        // texel under the leftmost pixel and the step per pixel, all 16.16
+        const int32_t du = (int32_t) (((int64_t) rx * step) >> 16);
+        const int32_t dv = (int32_t) (((int64_t) ry * step) >> 16);
+        //signed, the texel of a negative coordinate wraps from the end of the texture
+        int32_t u = pos_u + (int32_t) (((int64_t) fx * distance) >> 16) - du * half_width;
+        int32_t v = pos_v + (int32_t) (((int64_t) fy * distance) >> 16) - dv * half_width;
+
+        uint8_t *row = &(buffer->data[y * stride]);
+        for (uint16_t byte = 0; byte < stride; byte++) {
+            // collect 8 texels and write them as one byte
+            uint8_t bits = 0;
+            for (uint8_t bit = 0; bit < 8; bit++) {
+                int32_t tu = u >> 16;
+                int32_t tv = v >> 16;
+                if (pow2) {
+                    tu &= tex_width - 1;
+                    tv &= tex_height - 1;
+                } else {
+                    //floored modulo
+                    tu %= tex_width;
+                    tv %= tex_height;
+                    if (tu < 0) tu += tex_width;
+                    if (tv < 0) tv += tex_height;
+                }
+                bits |= ((tex[tv * tex_stride + (tu >> 3)] >> (tu & 7)) & 1) << bit;
+                u += du;
+                v += dv;
+            }
+            row[byte] = bits ^ invert;
+        }
+    }
+}
+
+void mode7_render_camera(Buffer *buffer, Mode7 *mode7) {
+    Vector position = get_camera();
+    position.x += buffer->width / 2;
+    position.y += buffer->height / 2;
+    mode7_render(buffer, mode7, &position, get_camera_rotation());
+}
@@ -0,0 +1,38 @@
+#pragma once
+#include "buffer.h"
+#include "../math/vector.h"
+
+typedef struct Mode7 Mode7;
+
+#define MAKE_MODE7(tex) (Mode7){ \
+    .texture=tex, \
+    .color=COLOR_BLACK, \
+    .horizon=20, \
+    .height=16, \
+    .focal=64, \
+    .scale=1 \
+}
+
+// perspective floor, every screen row below the horizon is a horizontal line of the tiled texture
+struct Mode7 {
+    Buffer *texture;    // tiled 1-bit floor texture, width must be a multiple of 8, power of two sizes are faster
+    PixelColor color;   // color of the set texels, the rest of the floor is drawn with the opposite color
+    uint8_t horizon;    // first screen row of the floor, rows above are left untouched
+    float height;       // camera height above the floor in world units
+    float focal;        // focal length in pixels, smaller values give a wider field of view
+    float scale;        // texels per world unit
+
+    // per row step of the DDA in 16.16 fixed point texels, filled by mode7_prepare
+    int32_t _row_distance[SCREEN_HEIGHT];
+    int32_t _row_step[SCREEN_HEIGHT];
+};
+
+// rebuilds the row tables, call after changing horizon, height, focal or scale
+void mode7_prepare(Mode7 *mode7);
+
+// position is the world point the viewer stands on, rotation is in degrees like Transform.rotation.
+// The texture is stepped in 16.16, position * scale has to stay within +-32767 texels
+void mode7_render(Buffer *buffer, Mode7 *mode7, Vector *position, float rotation);
+
+// renders from the point the camera is centered on, using the camera rotation
+void mode7_render_camera(Buffer *buffer, Mode7 *mode7);
@@ -3,36 +3,72 @@
 #include <float.h>
 
 #include "../math/equation.h"
+#include "../math/fixed.h"
 #include "../utils/helpers.h"
+#include "../context.h"
 
-static PixelColor render_color = COLOR_BLACK;
-static Matrix *current_transform;
 static Matrix identity_transform = IDENTITY_MATRIX;
-static Vector camera_position = {0, 0};
+
+static inline RenderState *render_state() {
+    return &(engine_context_current()->render);
+}
 #define EPSILON 1e-6f
 
 void set_camera(Vector position) {
-    camera_position = position;
+    render_state()->camera_position = position;
 }
 
 Vector get_camera() {
-    return camera_position;
+    return render_state()->camera_position;
+}
+
+void set_camera_rotation(float rotation) {
+    render_state()->camera_rotation = rotation;
+}
+
+float get_camera_rotation() {
+    return render_state()->camera_rotation;
 }
 
 void set_transform(Matrix *transform) {
     if (transform) {
-        current_transform = transform;
+        render_state()->transform = transform;
     } else {
-        current_transform = &identity_transform;
+        render_state()->transform = &identity_transform;
     }
 }
 
+void set_clip(int16_t x, int16_t y, int16_t width, int16_t height) {
+    RenderState *state = render_state();
+    state->clip_x0 = x;
+    state->clip_y0 = y;
+    state->clip_x1 = x + width - 1;
+    state->clip_y1 = y + height - 1;
+}
+
+void reset_clip() {
+    RenderState *state = render_state();
+    state->clip_x0 = INT16_MIN;
+    state->clip_y0 = INT16_MIN;
+    state->clip_x1 = INT16_MAX;
+    state->clip_y1 = INT16_MAX;
+}
+
+bool get_clip_rect(Buffer *buffer, int16_t *x0, int16_t *y0, int16_t *x1, int16_t *y1) {
+    RenderState *state = render_state();
+    *x0 = MAX(0, state->clip_x0);
+    *y0 = MAX(0, state->clip_y0);
+    *x1 = MIN(buffer->width - 1, state->clip_x1);
+    *y1 = MIN(buffer->height - 1, state->clip_y1);
+    return *x0 <= *x1 && *y0 <= *y1;
+}
+
 void set_color(PixelColor color) {
-    render_color = color;
+    render_state()->color = color;
 }
 
 void set_pixel(Buffer *buffer, Vector *screen) {
-    buffer_set_pixel(buffer, screen->x, screen->y, render_color);
+    buffer_set_pixel(buffer, screen->x, screen->y, render_state()->color);
 }
 
 void render_uv(Buffer *screen, RenderData *data, Vector *scaling, Vector *pixel, Vector *uv) {
@@ -79,7 +115,7 @@ void render_filled(Buffer *screen, RenderData *data, Vector *scaling, Vector *pi
     UNUSED(scaling);
     UNUSED(data);
     UNUSED(uv);
-    buffer_set_pixel(screen, pixel->x, pixel->y, render_color);
+    buffer_set_pixel(screen, pixel->x, pixel->y, render_state()->color);
 }
 
 void flip_uv(Poly *poly, FlipMode flip_mode) {
@@ -97,9 +133,227 @@ static float edge_function(Vector *const a, Vector *const b, Vector *const c) {
     return (c->x - a->x) * (b->y - a->y) - (c->y - a->y) * (b->x - a->x);
 }
 
-void rasterize_triangle(Buffer *buffer, RenderData *data, Vector *scaling,
-                        Vector *const A, Vector *const B, Vector *const C,
-                        Vector *const uvA, Vector *const uvB, Vector *const uvC) {
+typedef struct {
+    int32_t x, y;
+} SubpixelPoint;
+
+static inline SubpixelPoint to_subpixel(const Vector *v) {
+    return (SubpixelPoint) {fx_subpixel(v->x), fx_subpixel(v->y)};
+}
+
+// in 1/256 pixel^2, exact
+static inline int64_t edge_subpixel(const SubpixelPoint *a, const SubpixelPoint *b, int32_t x, int32_t y) {
+    return (int64_t) (x - a->x) * (b->y - a->y) - (int64_t) (y - a->y) * (b->x - a->x);
+}
+
+// The top-left rule is exact on integers: edges that do not own their pixels need a value of at least 1.
+// An edge is left if its value grows to the right, top if it is horizontal and the value grows downwards.
+static inline int64_t edge_min(int64_t dx, int64_t dy) {
+    return dx > 0 || (dx == 0 && dy > 0) ? 0 : 1;
+}
+
+#ifdef F0GE_FIXED_POINT
+// render_uv without floats, the texel is the integer part of uv * size
+static inline bool sample_fixed(Buffer *buffer, fixed u, fixed v) {
+    const int32_t U = (int32_t) (((int64_t) u * buffer->real_width) >> FX_SHIFT);
+    const int32_t V = (int32_t) (((int64_t) v * buffer->height) >> FX_SHIFT);
+    if (U < 0 || U >= buffer->real_width || V < 0 || V >= buffer->height) return false;
+    return buffer_read_pixel(buffer, U, V);
+}
+
+static inline void shade_fixed(Buffer *buffer, RenderData *data, int16_t x, int16_t y, fixed u, fixed v,
+                               fixed scale_u, fixed scale_v) {
+    if (data->tile_mode != TILE_NONE) {
+        u = fx_mul(u, scale_u);
+        v = fx_mul(v, scale_v);
+        //the fraction of a two's complement number wraps negative values into 0..1 as well
+        if (data->tile_mode & TILE_HORIZONTAL) u &= FX_FRACTION;
+        if (data->tile_mode & TILE_VERTICAL) v &= FX_FRACTION;
+    } else if (u < 0 || u > FX_ONE || v < 0 || v > FX_ONE) {
+        return;
+    }
+    if (data->mask && sample_fixed(data->mask, u, v)) buffer_set_pixel(buffer, x, y, data->mask_color);
+    if (sample_fixed(data->sprite, u, v)) buffer_set_pixel(buffer, x, y, data->color);
+}
+
+// An interpolated value stepped without rounding drift: the exact value is value + remainder / area,
+// the remainder is kept in 0..area-1 like a Bresenham error term.
+typedef struct {
+    fixed value;
+    int64_t remainder;
+} FixedStep;
+
+static inline FixedStep fixed_step(int64_t numerator, int64_t area) {
+    int64_t value = numerator / area;
+    int64_t remainder = numerator % area;
+    if (remainder < 0) {
+        value--;
+        remainder += area;
+    }
+    return (FixedStep) {fx_saturate(value), remainder};
+}
+
+static inline void fixed_advance(FixedStep *step, const FixedStep *delta, int64_t area) {
+    step->value += delta->value;
+    step->remainder += delta->remainder;
+    if (step->remainder >= area) {
+        step->remainder -= area;
+        step->value++;
+    }
+}
+
+// uv at a point from the edge values, area weighted
+static inline FixedStep interpolate(int64_t e0, int64_t e1, int64_t e2, fixed a, fixed b, fixed c, int64_t area) {
+    return fixed_step(e0 * a + e1 * b + e2 * c, area);
+}
+
+#endif
+
+// Pixels whose center lies exactly on an edge are drawn by every triangle sharing it, unless shared_edges is set:
+// then only top and left edges own their pixels (the top-left rule), so neighbouring triangles of a mesh
+// neither overlap nor leave gaps.
+#ifdef F0GE_FIXED_POINT
+static void raster_triangle(Buffer *buffer, RenderData *data, Vector *scaling,
+                            Vector *const A, Vector *const B, Vector *const C,
+                            Vector *const uvA, Vector *const uvB, Vector *const uvC, bool shared_edges) {
+    const SubpixelPoint a = to_subpixel(A), b = to_subpixel(B), c = to_subpixel(C);
+    const int64_t area = edge_subpixel(&a, &b, c.x, c.y);
+    // Check if the triangle is visible and front-facing
+    if (area <= 0) return;
+
+    // Compute the bounding box of the triangle, clipped to the target buffer
+    RenderState *state = render_state();
+    const int32_t one = FX_SUBPIXEL_ONE;
+    int16_t minX = MAX(MAX(0, state->clip_x0), MIN(MIN(a.x, b.x), c.x) >> FX_SUBPIXEL_BITS);
+    int16_t minY = MAX(MAX(0, state->clip_y0), MIN(MIN(a.y, b.y), c.y) >> FX_SUBPIXEL_BITS);
+    int16_t maxX = MIN(MIN(buffer->width - 1, state->clip_x1),
+                       (MAX(MAX(a.x, b.x), c.x) + one - 1) >> FX_SUBPIXEL_BITS);
+    int16_t maxY = MIN(MIN(buffer->height - 1, state->clip_y1),
+                       (MAX(MAX(a.y, b.y), c.y) + one - 1) >> FX_SUBPIXEL_BITS);
+    if (minX > maxX || minY > maxY) return;
+
+    // Edge values at the center of the first pixel and their steps per pixel
+    const int32_t px = minX * one + one / 2, py = minY * one + one / 2;
+    int64_t e0_row = edge_subpixel(&b, &c, px, py);
+    int64_t e1_row = edge_subpixel(&c, &a, px, py);
+    int64_t e2_row = edge_subpixel(&a, &b, px, py);
+    const int64_t e0_dx = (int64_t) (c.y - b.y) * one, e0_dy = (int64_t) (b.x - c.x) * one;
+    const int64_t e1_dx = (int64_t) (a.y - c.y) * one, e1_dy = (int64_t) (c.x - a.x) * one;
+    const int64_t e2_dx = (int64_t) (b.y - a.y) * one, e2_dy = (int64_t) (a.x - b.x) * one;
+
+    const int64_t e0_min = shared_edges ? edge_min(e0_dx, e0_dy) : 0;
+    const int64_t e1_min = shared_edges ? edge_min(e1_dx, e1_dy) : 0;
+    const int64_t e2_min = shared_edges ? edge_min(e2_dx, e2_dy) : 0;
+
+    // uv steps per pixel, the value at the start of each row is computed from the edge values again
+    const fixed uA = fx_from_float(uvA->x), uB = fx_from_float(uvB->x), uC = fx_from_float(uvC->x);
+    const fixed vA = fx_from_float(uvA->y), vB = fx_from_float(uvB->y), vC = fx_from_float(uvC->y);
+    const FixedStep u_dx = interpolate(e0_dx, e1_dx, e2_dx, uA, uB, uC, area);
+    const FixedStep v_dx = interpolate(e0_dx, e1_dx, e2_dx, vA, vB, vC, area);
+    const fixed scale_u = fx_from_float(scaling->x), scale_v = fx_from_float(scaling->y);
+    const bool textured = data->callback == render_uv;
+    const bool filled = data->callback == render_filled;
+    Vector pixel, uv;
+
+    for (int16_t y = minY; y <= maxY; y++) {
+        int64_t e0 = e0_row, e1 = e1_row, e2 = e2_row;
+        FixedStep u = interpolate(e0, e1, e2, uA, uB, uC, area);
+        FixedStep v = interpolate(e0, e1, e2, vA, vB, vC, area);
+
+        for (int16_t x = minX; x <= maxX; x++) {
+            if ((e0 >= e0_min) & (e1 >= e1_min) & (e2 >= e2_min)) {
+                if (textured) {
+                    shade_fixed(buffer, data, x, y, u.value, v.value, scale_u, scale_v);
+                } else if (filled) {
+                    buffer_set_pixel(buffer, x, y, state->color);
+                } else {
+                    //custom callbacks still take floats
+                    pixel = (Vector) {x, y};
+                    uv = (Vector) {fx_to_float(u.value), fx_to_float(v.value)};
+                    data->callback(buffer, data, scaling, &pixel, &uv);
+                }
+            }
+            e0 += e0_dx;
+            e1 += e1_dx;
+            e2 += e2_dx;
+            fixed_advance(&u, &u_dx, area);
+            fixed_advance(&v, &v_dx, area);
+        }
+
+        e0_row += e0_dy;
+        e1_row += e1_dy;
+        e2_row += e2_dy;
+    }
+}
+#else
+// Meshes test coverage on the snapped integer edges of the fixed point build: normalized float weights stepped
+// across the row round differently in each triangle, so pixels on a shared edge were drawn twice or not at all.
+// The uv is still interpolated with float weights.
+static void raster_mesh_triangle(Buffer *buffer, RenderData *data, Vector *scaling,
+                                 Vector *const A, Vector *const B, Vector *const C,
+                                 Vector *const uvA, Vector *const uvB, Vector *const uvC) {
+    const SubpixelPoint a = to_subpixel(A), b = to_subpixel(B), c = to_subpixel(C);
+    const int64_t area = edge_subpixel(&a, &b, c.x, c.y);
+    if (area <= 0) return;
+
+    RenderState *state = render_state();
+    const int32_t one = FX_SUBPIXEL_ONE;
+    int16_t minX = MAX(MAX(0, state->clip_x0), MIN(MIN(a.x, b.x), c.x) >> FX_SUBPIXEL_BITS);
+    int16_t minY = MAX(MAX(0, state->clip_y0), MIN(MIN(a.y, b.y), c.y) >> FX_SUBPIXEL_BITS);
+    int16_t maxX = MIN(MIN(buffer->width - 1, state->clip_x1),
+                       (MAX(MAX(a.x, b.x), c.x) + one - 1) >> FX_SUBPIXEL_BITS);
+    int16_t maxY = MIN(MIN(buffer->height - 1, state->clip_y1),
+                       (MAX(MAX(a.y, b.y), c.y) + one - 1) >> FX_SUBPIXEL_BITS);
+    if (minX > maxX || minY > maxY) return;
+
+    const int32_t px = minX * one + one / 2, py = minY * one + one / 2;
+    int64_t e0_row = edge_subpixel(&b, &c, px, py);
+    int64_t e1_row = edge_subpixel(&c, &a, px, py);
+    int64_t e2_row = edge_subpixel(&a, &b, px, py);
+    const int64_t e0_dx = (int64_t) (c.y - b.y) * one, e0_dy = (int64_t) (b.x - c.x) * one;
+    const int64_t e1_dx = (int64_t) (a.y - c.y) * one, e1_dy = (int64_t) (c.x - a.x) * one;
+    const int64_t e2_dx = (int64_t) (b.y - a.y) * one, e2_dy = (int64_t) (a.x - b.x) * one;
+    const int64_t e0_min = edge_min(e0_dx, e0_dy), e1_min = edge_min(e1_dx, e1_dy), e2_min = edge_min(e2_dx, e2_dy);
+
+    // weights of the snapped triangle, exact up to the float conversion
+    const float inverse = 1.0f / (float) area;
+    const float w0_dx = e0_dx * inverse, w1_dx = e1_dx * inverse, w2_dx = e2_dx * inverse;
+    Vector pixel, uv;
+
+    for (int16_t y = minY; y <= maxY; y++) {
+        pixel.y = y;
+        int64_t e0 = e0_row, e1 = e1_row, e2 = e2_row;
+        float w0 = e0 * inverse, w1 = e1 * inverse, w2 = e2 * inverse;
+
+        for (int16_t x = minX; x <= maxX; x++) {
+            if ((e0 >= e0_min) & (e1 >= e1_min) & (e2 >= e2_min)) {
+                pixel.x = x;
+                uv.x = w0 * uvA->x + w1 * uvB->x + w2 * uvC->x;
+                uv.y = w0 * uvA->y + w1 * uvB->y + w2 * uvC->y;
+                data->callback(buffer, data, scaling, &pixel, &uv);
+            }
+            e0 += e0_dx;
+            e1 += e1_dx;
+            e2 += e2_dx;
+            w0 += w0_dx;
+            w1 += w1_dx;
+            w2 += w2_dx;
+        }
+
+        e0_row += e0_dy;
+        e1_row += e1_dy;
+        e2_row += e2_dy;
+    }
+}
+
+static void raster_triangle(Buffer *buffer, RenderData *data, Vector *scaling,
+                            Vector *const A, Vector *const B, Vector *const C,
+                            Vector *const uvA, Vector *const uvB, Vector *const uvC, bool shared_edges) {
+    if (shared_edges) {
+        raster_mesh_triangle(buffer, data, scaling, A, B, C, uvA, uvB, uvC);
+        return;
+    }
+
     // Precompute the full triangle area (for barycentric coordinates)
     float area = edge_function(A, B, C);
 
@@ -107,11 +361,13 @@ void rasterize_triangle(Buffer *buffer, RenderData *data, Vector *scaling,
     if (area <= EPSILON) return;
 
 
-    // Compute the bounding box of the triangle
-    uint8_t minX = MAX(0, FLOOR(MIN(MIN(A->x, B->x), C->x)));
-    uint8_t minY = MAX(0, FLOOR(MIN(MIN(A->y, B->y), C->y)));
-    uint8_t maxX = MIN(SCREEN_WIDTH - 1, CEIL(MAX(MAX(A->x, B->x), C->x)));
-    uint8_t maxY = MIN(SCREEN_HEIGHT - 1, CEIL(MAX(MAX(A->y, B->y), C->y)));
+    // Compute the bounding box of the triangle, clipped to the target buffer
+    RenderState *state = render_state();
+    int16_t minX = MAX(MAX(0, state->clip_x0), FLOOR(MIN(MIN(A->x, B->x), C->x)));
+    int16_t minY = MAX(MAX(0, state->clip_y0), FLOOR(MIN(MIN(A->y, B->y), C->y)));
+    int16_t maxX = MIN(MIN(buffer->width - 1, state->clip_x1), CEIL(MAX(MAX(A->x, B->x), C->x)));
+    int16_t maxY = MIN(MIN(buffer->height - 1, state->clip_y1), CEIL(MAX(MAX(A->y, B->y), C->y)));
+    if (minX > maxX || minY > maxY) return;
 
     Vector pixel, uv;
 
@@ -133,14 +389,14 @@ void rasterize_triangle(Buffer *buffer, RenderData *data, Vector *scaling,
     float w0, w1, w2;
 
     // Rasterize the triangle
-    for (uint8_t y = minY; y <= maxY; y++) {
+    for (int16_t y = minY; y <= maxY; y++) {
         pixel.y = y;
         // Start barycentric weights for this row
         w0 = w0_row;
         w1 = w1_row;
         w2 = w2_row;
 
-        for (uint8_t x = minX; x <= maxX; x++) {
+        for (int16_t x = minX; x <= maxX; x++) {
             pixel.x = x;
 
             // Check if the point is inside the triangle
@@ -163,6 +419,13 @@ void rasterize_triangle(Buffer *buffer, RenderData *data, Vector *scaling,
         w2_row += w2_dy;
     }
 }
+#endif
+
+void rasterize_triangle(Buffer *buffer, RenderData *data, Vector *scaling,
+                        Vector *const A, Vector *const B, Vector *const C,
+                        Vector *const uvA, Vector *const uvB, Vector *const uvC) {
+    raster_triangle(buffer, data, scaling, A, B, C, uvA, uvB, uvC, false);
+}
 
 void rasterize(Buffer *buffer, RenderData *data, Vector cachedCorner[4]) {
     if (!buffer) return;
@@ -175,37 +438,31 @@ void rasterize(Buffer *buffer, RenderData *data, Vector cachedCorner[4]) {
 
     // timer = timer_start("cull");
 
+    RenderState *state = render_state();
+    Vector *camera_position = &(state->camera_position);
     Vector corner[4];
 
     float x_min = FLT_MAX, x_max = -FLT_MAX, y_min = FLT_MAX, y_max = -FLT_MAX;
 
-    Vector scale;
-    matrix_get_scaling(current_transform, &scale);
-    bool within_screen = false; // To determine if any corner is inside the screen
-
     // frustum cull
     for (int i = 0; i < 4; i++) {
-        // matrix_mul_vector(current_transform, &(data->poly.corners[i]), &(cachedCorner[i]));
-
-
-        corner[i] = (Vector){cachedCorner[i].x - camera_position.x, cachedCorner[i].y - camera_position.y};
-        x_min = MIN(corner[i].x, corner[(i + 1) % 4].x);
-        x_max = MAX(corner[i].x, corner[(i + 1) % 4].x);
-        y_min = MIN(corner[i].y, corner[(i + 1) % 4].y);
-        y_max = MAX(corner[i].y, corner[(i + 1) % 4].y);
-        if (corner[i].x >= 0 && corner[i].x < SCREEN_WIDTH &&
-            corner[i].y >= 0 && corner[i].y < SCREEN_HEIGHT) {
-            within_screen = true;
-        }
+        corner[i] = (Vector){cachedCorner[i].x - camera_position->x, cachedCorner[i].y - camera_position->y};
+        x_min = MIN(x_min, corner[i].x);
+        x_max = MAX(x_max, corner[i].x);
+        y_min = MIN(y_min, corner[i].y);
+        y_max = MAX(y_max, corner[i].y);
     }
 
     // timer_end(timer);
-    // Check if the AABB overlaps the screen
-    if (!within_screen && (x_min < 0 && x_max >= SCREEN_WIDTH && y_min < 0 && y_max >= SCREEN_HEIGHT)) {
+    // Check if the AABB of all corners overlaps the target
+    if (x_max < 0 || x_min >= buffer->width || y_max < 0 || y_min >= buffer->height) {
         // Sprite is fully outside the screen bounds
         return;
     }
 
+    Vector scale;
+    matrix_get_scaling(state->transform, &scale);
+
 
     // timer = timer_start("raster");
     rasterize_triangle(buffer, data, &scale,
@@ -221,35 +478,49 @@ void rasterize(Buffer *buffer, RenderData *data, Vector cachedCorner[4]) {
     // timer_end(timer);
 }
 
-void draw_line(Buffer *buffer, Vector *a, Vector *b) {
-    Vector _a, _b;
-    matrix_mul_vector(current_transform, a, &_a);
-    matrix_mul_vector(current_transform, b, &_b);
-    int16_t _x0 = (int16_t) _a.x - camera_position.x;
-    int16_t _x1 = (int16_t) _b.x - camera_position.x;
-    int16_t _y0 = (int16_t) _a.y - camera_position.y;
-    int16_t _y1 = (int16_t) _b.y - camera_position.y;
-    int dx = abs(_x1 - _x0);
-    int16_t sx = _x0 < _x1 ? 1 : -1;
+void rasterize_mesh(Buffer *buffer, RenderData *data, Vector *vertices) {
+    if (!buffer || !vertices) return;
+    if (!data->callback) {
+        data->callback = data->sprite ? render_uv : render_filled;
+    }
 
-    int dy = abs(_y1 - _y0);
-    int16_t sy = _y0 < _y1 ? 1 : -1;
+    RenderState *state = render_state();
+    Vector *camera_position = &(state->camera_position);
+    Mesh *mesh = data->mesh;
 
-    int err = (dx > dy ? dx : -dy) / 2;
+    // frustum cull of the whole mesh
+    float x_min = FLT_MAX, x_max = -FLT_MAX, y_min = FLT_MAX, y_max = -FLT_MAX;
+    for (uint8_t i = 0; i < mesh->vertex_count; i++) {
+        x_min = MIN(x_min, vertices[i].x);
+        x_max = MAX(x_max, vertices[i].x);
+        y_min = MIN(y_min, vertices[i].y);
+        y_max = MAX(y_max, vertices[i].y);
+    }
+    x_min -= camera_position->x;
+    x_max -= camera_position->x;
+    y_min -= camera_position->y;
+    y_max -= camera_position->y;
+    if (x_max < 0 || x_min >= buffer->width || y_max < 0 || y_min >= buffer->height) return;
 
-    while (true) {
-        if (buffer_test_coordinate(buffer, _x0, _y0)) {
-            buffer_set_pixel(buffer, _x0, _y0, render_color);
-        }
-        if (_x0 == _x1 && _y0 == _y1) break;
-        int e2 = err;
-        if (e2 > -dx) {
-            err -= dy;
-            _x0 += sx;
-        }
-        if (e2 < dy) {
-            err += dx;
-            _y0 += sy;
+    Vector scale;
+    matrix_get_scaling(state->transform, &scale);
+
+    const uint8_t *triangles = mesh->triangles;
+    for (uint8_t t = 0; t < mesh->triangle_count; t++, triangles += 3) {
+        const uint8_t a = triangles[0], b = triangles[1], c = triangles[2];
+        if (a >= mesh->vertex_count || b >= mesh->vertex_count || c >= mesh->vertex_count) continue;
+        Vector corner[3] = {
+            {vertices[a].x - camera_position->x, vertices[a].y - camera_position->y},
+            {vertices[b].x - camera_position->x, vertices[b].y - camera_position->y},
+            {vertices[c].x - camera_position->x, vertices[c].y - camera_position->y},
+        };
+        //either winding, back facing triangles are turned around
+        if (edge_function(&(corner[0]), &(corner[1]), &(corner[2])) > 0) {
+            raster_triangle(buffer, data, &scale, &(corner[0]), &(corner[1]), &(corner[2]),
+                            &(mesh->uv[a]), &(mesh->uv[b]), &(mesh->uv[c]), true);
+        } else {
+            raster_triangle(buffer, data, &scale, &(corner[0]), &(corner[2]), &(corner[1]),
+                            &(mesh->uv[a]), &(mesh->uv[c]), &(mesh->uv[b]), true);
         }
     }
 }
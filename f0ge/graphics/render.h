@@ -2,6 +2,7 @@
 #include "../math/matrix.h"
 #include "../math/vector.h"
 #include "buffer.h"
+#include "draw.h"
 
 typedef struct RenderData RenderData;
 
@@ -33,8 +34,27 @@ typedef struct {
 .uv = {{0, 0},{1, 0},{1, 1},{0, 1}}\
 }
 
+// Triangle mesh in place of the quad of a Poly, for sprites that fit their shape tightly or deform.
+// The engine keeps the transformed vertices of every node using it, the mesh itself can be shared.
+typedef struct {
+    Vector *vertices;           // local space, like Poly.corners
+    Vector *uv;
+    const uint8_t *triangles;   // 3 vertex indices per triangle, either winding
+    uint8_t vertex_count;
+    uint8_t triangle_count;
+} Mesh;
+
+#define MAKE_MESH(mesh_vertices, mesh_uv, mesh_triangles, vertices_count, triangles_count) (Mesh){ \
+    .vertices=mesh_vertices, \
+    .uv=mesh_uv, \
+    .triangles=mesh_triangles, \
+    .vertex_count=vertices_count, \
+    .triangle_count=triangles_count \
+}
+
 struct RenderData {
     Poly poly;
+    Mesh *mesh;     // drawn instead of poly when set
     Buffer *sprite;
     Buffer *mask;
     PixelColor color;
@@ -44,22 +64,56 @@ struct RenderData {
     void (*callback)(Buffer *screen, RenderData *data, Vector *scaling, Vector *pixel, Vector *uv);
 };
 
+// per engine context state of the renderer
+typedef struct {
+    PixelColor color;
+    Matrix *transform;
+    Vector camera_position;
+    float camera_rotation;
+    int16_t clip_x0, clip_y0, clip_x1, clip_y1;
+} RenderState;
+
+#define DEFAULT_RENDER_STATE { \
+    .color=COLOR_BLACK, \
+    .transform=NULL, \
+    .camera_position={0, 0}, \
+    .camera_rotation=0, \
+    .clip_x0=INT16_MIN, \
+    .clip_y0=INT16_MIN, \
+    .clip_x1=INT16_MAX, \
+    .clip_y1=INT16_MAX \
+}
+
 void set_camera(Vector position);
 
 Vector get_camera();
 
+// only used by renderers that support it (eg. mode7), in degrees
+void set_camera_rotation(float rotation);
+
+float get_camera_rotation();
+
 void render_uv(Buffer *screen, RenderData *data, Vector *scaling, Vector *pixel, Vector *uv);
 
 void render_filled(Buffer *screen, RenderData *data, Vector *scaling, Vector *pixel, Vector *uv);
 
 void set_transform(Matrix *transform);
 
+// limits rasterization to a screen space rectangle
+void set_clip(int16_t x, int16_t y, int16_t width, int16_t height);
+
+void reset_clip();
+
+// the clip rectangle limited to the buffer, inclusive, false if nothing is left
+bool get_clip_rect(Buffer *buffer, int16_t *x0, int16_t *y0, int16_t *x1, int16_t *y1);
+
 void set_pixel(Buffer *buffer, Vector *screen);
 
 void set_color(PixelColor color);
 
 void rasterize(Buffer *buffer, RenderData *data, Vector cachedCorner[4]);
 
-void draw_line(Buffer *buffer, Vector *a, Vector *b);
+// vertices are the transformed mesh vertices, triangles share their edges without gaps or double pixels
+void rasterize_mesh(Buffer *buffer, RenderData *data, Vector *vertices);
 
 void flip_uv(Poly *poly, FlipMode flip_mode);
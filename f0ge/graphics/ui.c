@@ -0,0 +1,293 @@
+#include "ui.h"
+#include "../utils/helpers.h"
+
+typedef struct {
+    UiLayer *ui;
+    UiRect area;
+} UiDrawArea;
+
+UiLayer *ui_create(uint8_t width, uint8_t height, uint8_t capacity) {
+    UiLayer *ui = allocate(sizeof(UiLayer));
+    check_pointer(ui);
+    ui->layer = layer_create(width, height);
+    ui->widgets = allocate(sizeof(UiWidget) * capacity);
+    check_pointer(ui->widgets);
+    ui->count = 0;
+    ui->capacity = capacity;
+    ui->x = 0;
+    ui->y = 0;
+    ui->visible = true;
+    return ui;
+}
+
+void ui_release(UiLayer *ui) {
+    if (!ui) return;
+    layer_release(ui->layer);
+    release(ui->widgets);
+    release(ui);
+}
+
+static inline bool rect_empty(const UiRect *r) {
+    return r->width <= 0 || r->height <= 0;
+}
+
+static bool rect_overlaps(const UiRect *a, const UiRect *b) {
+    if (rect_empty(a) || rect_empty(b)) return false;
+    return a->x < b->x + b->width && b->x < a->x + a->width && a->y < b->y + b->height && b->y < a->y + a->height;
+}
+
+static bool rect_contains(const UiRect *outer, const UiRect *inner) {
+    if (rect_empty(inner)) return true;
+    return inner->x >= outer->x && inner->y >= outer->y && inner->x + inner->width <= outer->x + outer->width &&
+           inner->y + inner->height <= outer->y + outer->height;
+}
+
+static void rect_add(UiRect *r, const UiRect *other) {
+    if (rect_empty(other)) return;
+    if (rect_empty(r)) {
+        *r = *other;
+        return;
+    }
+    const int16_t x1 = MAX(r->x + r->width, other->x + other->width);
+    const int16_t y1 = MAX(r->y + r->height, other->y + other->height);
+    r->x = MIN(r->x, other->x);
+    r->y = MIN(r->y, other->y);
+    r->width = x1 - r->x;
+    r->height = y1 - r->y;
+}
+
+static UiRect widget_rect(UiWidget *widget) {
+    if (!widget->visible) return (UiRect) {0, 0, 0, 0};
+    UiRect r = {widget->x, widget->y, widget->width, widget->height};
+    if (widget->type == UiWidgetLabel) {
+        if (widget->label.align == AlignCenter) r.x -= r.width / 2;
+        else if (widget->label.align == AlignRight) r.x -= r.width;
+    }
+    return r;
+}
+
+static void measure_label(UiWidget *widget) {
+    const Font *font = widget->label.font;
+    uint8_t lines = 1;
+    for (const char *c = widget->label.text; *c; c++) {
+        if (*c == '\n') lines++;
+    }
+    widget->width = font_measure(font, widget->label.text);
+    widget->height = (lines - 1) * font->line_height + font->height;
+}
+
+static UiWidget *add_widget(UiLayer *ui, UiWidgetType type, int16_t x, int16_t y, uint8_t width, uint8_t height) {
+    if (ui->count == ui->capacity) {
+        FURI_LOG_E("UI", "No room for more widgets");
+        return NULL;
+    }
+    UiWidget *widget = &(ui->widgets[ui->count++]);
+    memset(widget, 0, sizeof(UiWidget));
+    widget->type = type;
+    widget->x = x;
+    widget->y = y;
+    widget->width = width;
+    widget->height = height;
+    widget->color = COLOR_BLACK;
+    widget->visible = true;
+    widget->dirty = true;
+    return widget;
+}
+
+UiWidget *ui_add_label(UiLayer *ui, const Font *font, const char *text, int16_t x, int16_t y, TextAlign align) {
+    UiWidget *widget = add_widget(ui, UiWidgetLabel, x, y, 0, 0);
+    if (!widget) return NULL;
+    widget->label.font = font;
+    widget->label.align = align;
+    snprintf(widget->label.text, UI_LABEL_LENGTH, "%s", text);
+    measure_label(widget);
+    return widget;
+}
+
+UiWidget *ui_add_bar(UiLayer *ui, int16_t x, int16_t y, uint8_t width, uint8_t height, int32_t max) {
+    UiWidget *widget = add_widget(ui, UiWidgetBar, x, y, width, height);
+    if (!widget) return NULL;
+    widget->bar.value = max;
+    widget->bar.max = max;
+    widget->bar.vertical = false;
+    widget->bar.frame = true;
+    return widget;
+}
+
+UiWidget *ui_add_icon(UiLayer *ui, Buffer *sprite, Buffer *mask, int16_t x, int16_t y) {
+    check_pointer(sprite);
+    UiWidget *widget = add_widget(ui, UiWidgetIcon, x, y, sprite->real_width, sprite->height);
+    if (!widget) return NULL;
+    widget->icon.sprite = sprite;
+    widget->icon.mask = mask;
+    return widget;
+}
+
+UiWidget *ui_add_custom(UiLayer *ui, int16_t x, int16_t y, uint8_t width, uint8_t height,
+                        void (*draw)(Buffer *target, UiWidget *widget, void *context), void *context) {
+    UiWidget *widget = add_widget(ui, UiWidgetCustom, x, y, width, height);
+    if (!widget) return NULL;
+    widget->custom.draw = draw;
+    widget->custom.context = context;
+    return widget;
+}
+
+void ui_set_text(UiWidget *widget, const char *text) {
+    if (widget->type != UiWidgetLabel || strncmp(widget->label.text, text, UI_LABEL_LENGTH - 1) == 0) return;
+    snprintf(widget->label.text, UI_LABEL_LENGTH, "%s", text);
+    measure_label(widget);
+    widget->dirty = true;
+}
+
+void ui_set_number(UiWidget *widget, int32_t value) {
+    char text[12];
+    snprintf(text, sizeof(text), "%ld", (long) value);
+    ui_set_text(widget, text);
+}
+
+void ui_set_value(UiWidget *widget, int32_t value) {
+    if (widget->type != UiWidgetBar || widget->bar.value == value) return;
+    widget->bar.value = value;
+    widget->dirty = true;
+}
+
+void ui_set_visible(UiWidget *widget, bool visible) {
+    if (widget->visible == visible) return;
+    widget->visible = visible;
+    widget->dirty = true;
+}
+
+void ui_set_color(UiWidget *widget, PixelColor color) {
+    if (widget->color == color) return;
+    widget->color = color;
+    widget->dirty = true;
+}
+
+void ui_move(UiWidget *widget, int16_t x, int16_t y) {
+    if (widget->x == x && widget->y == y) return;
+    widget->x = x;
+    widget->y = y;
+    widget->dirty = true;
+}
+
+void ui_invalidate(UiWidget *widget) {
+    widget->dirty = true;
+}
+
+static void draw_bar(Buffer *target, UiWidget *widget, UiRect *r) {
+    if (widget->bar.frame) {
+        buffer_fill_rect(target, r->x, r->y, r->width, 1, widget->color);
+        buffer_fill_rect(target, r->x, r->y + r->height - 1, r->width, 1, widget->color);
+        buffer_fill_rect(target, r->x, r->y + 1, 1, r->height - 2, widget->color);
+        buffer_fill_rect(target, r->x + r->width - 1, r->y + 1, 1, r->height - 2, widget->color);
+        r->x += 1;
+        r->y += 1;
+        r->width -= 2;
+        r->height -= 2;
+    }
+    if (widget->bar.max <= 0) return;
+    const int32_t value = MIN(MAX(widget->bar.value, 0), widget->bar.max);
+    if (widget->bar.vertical) {
+        const int16_t fill = r->height * value / widget->bar.max;
+        buffer_fill_rect(target, r->x, r->y + r->height - fill, r->width, fill, widget->color);
+    } else {
+        buffer_fill_rect(target, r->x, r->y, r->width * value / widget->bar.max, r->height, widget->color);
+    }
+}
+
+static void draw_widget(Buffer *target, UiWidget *widget) {
+    UiRect r = widget_rect(widget);
+    switch (widget->type) {
+        case UiWidgetLabel:
+            font_draw_text(target, widget->label.font, widget->label.text, r.x, r.y, widget->color);
+            break;
+        case UiWidgetBar:
+            draw_bar(target, widget, &r);
+            break;
+        case UiWidgetIcon:
+            buffer_blit(target, widget->icon.sprite, widget->icon.mask, r.x, r.y);
+            break;
+        case UiWidgetCustom:
+            widget->custom.draw(target, widget, widget->custom.context);
+            break;
+    }
+}
+
+static void draw_area(Buffer *target, void *context) {
+    UiDrawArea *area = context;
+    for (uint8_t i = 0; i < area->ui->count; i++) {
+        UiWidget *widget = &(area->ui->widgets[i]);
+        UiRect r = widget_rect(widget);
+        if (rect_overlaps(&(area->area), &r)) draw_widget(target, widget);
+    }
+}
+
+static void draw_all(Buffer *target, void *context) {
+    UiLayer *ui = context;
+    for (uint8_t i = 0; i < ui->count; i++) {
+        if (ui->widgets[i].visible) draw_widget(target, &(ui->widgets[i]));
+    }
+}
+
+// grows the area until every widget it touches is completely inside, so redrawing it leaves no cut off pixels
+static void close_area(UiLayer *ui, UiRect *area) {
+    bool grown;
+    do {
+        grown = false;
+        for (uint8_t i = 0; i < ui->count; i++) {
+            UiWidget *widget = &(ui->widgets[i]);
+            UiRect r = widget_rect(widget);
+            if (rect_overlaps(area, &r) && !rect_contains(area, &r)) {
+                rect_add(area, &r);
+                grown = true;
+            }
+            //pixels a pending widget left at its old place go away with it
+            if (widget->dirty && rect_overlaps(area, &(widget->drawn)) && !rect_contains(area, &(widget->drawn))) {
+                rect_add(area, &(widget->drawn));
+                grown = true;
+            }
+        }
+    } while (grown);
+}
+
+uint8_t ui_update(UiLayer *ui) {
+    if (ui->layer->dirty) {
+        layer_draw(ui->layer, draw_all, ui);
+        for (uint8_t i = 0; i < ui->count; i++) {
+            ui->widgets[i].dirty = false;
+            ui->widgets[i].drawn = widget_rect(&(ui->widgets[i]));
+        }
+        return 1;
+    }
+
+    uint8_t areas = 0;
+    for (uint8_t i = 0; i < ui->count; i++) {
+        UiWidget *widget = &(ui->widgets[i]);
+        if (!widget->dirty) continue;
+
+        UiDrawArea area = {.ui=ui, .area=widget->drawn};
+        UiRect r = widget_rect(widget);
+        rect_add(&(area.area), &r);
+        close_area(ui, &(area.area));
+        if (!rect_empty(&(area.area))) {
+            layer_draw_area(ui->layer, area.area.x, area.area.y, area.area.width, area.area.height, draw_area, &area);
+            areas++;
+        }
+
+        for (uint8_t j = 0; j < ui->count; j++) {
+            UiWidget *other = &(ui->widgets[j]);
+            UiRect current = widget_rect(other);
+            if (rect_contains(&(area.area), &current) && rect_contains(&(area.area), &(other->drawn))) {
+                other->dirty = false;
+                other->drawn = current;
+            }
+        }
+    }
+    return areas;
+}
+
+void ui_render(UiLayer *ui, Buffer *target) {
+    if (!ui->visible) return;
+    ui_update(ui);
+    layer_composite(ui->layer, target, ui->x, ui->y);
+}
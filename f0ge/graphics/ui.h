@@ -0,0 +1,103 @@
+#pragma once
+#include "buffer.h"
+#include "font.h"
+#include "layer.h"
+
+// Retained HUD: widgets keep their state and their pixels are cached in a LayerCache.
+// Changing a widget only redraws the area it covers (and the widgets overlapping it),
+// every frame the whole layer is composited into the screen with one masked blit.
+
+#define UI_LABEL_LENGTH 24
+
+typedef struct UiWidget UiWidget;
+typedef struct UiLayer UiLayer;
+
+typedef enum {
+    UiWidgetLabel,
+    UiWidgetBar,
+    UiWidgetIcon,
+    UiWidgetCustom,
+} UiWidgetType;
+
+typedef struct {
+    int16_t x, y;
+    int16_t width, height;
+} UiRect;
+
+struct UiWidget {
+    UiWidgetType type;
+    int16_t x, y;           // layer position, labels are anchored by their align
+    uint8_t width, height;  // labels are measured
+    PixelColor color;
+    bool visible;
+    bool dirty;
+    UiRect drawn;           // area covered the last time the widget was drawn
+
+    union {
+        struct {
+            const Font *font;
+            TextAlign align;
+            char text[UI_LABEL_LENGTH];
+        } label;
+        struct {
+            int32_t value;
+            int32_t max;
+            bool vertical;  // fills up from the bottom instead of from the left
+            bool frame;     // 1 pixel border around the fill
+        } bar;
+        struct {
+            Buffer *sprite;
+            Buffer *mask;   // NULL draws the set pixels of the sprite
+        } icon;
+        struct {
+            // has to stay inside the widget area
+            void (*draw)(Buffer *target, UiWidget *widget, void *context);
+            void *context;
+        } custom;
+    };
+};
+
+struct UiLayer {
+    LayerCache *layer;
+    UiWidget *widgets;
+    uint8_t count;
+    uint8_t capacity;
+    int16_t x, y;           // screen position of the layer
+    bool visible;
+};
+
+UiLayer *ui_create(uint8_t width, uint8_t height, uint8_t capacity);
+
+void ui_release(UiLayer *ui);
+
+UiWidget *ui_add_label(UiLayer *ui, const Font *font, const char *text, int16_t x, int16_t y, TextAlign align);
+
+UiWidget *ui_add_bar(UiLayer *ui, int16_t x, int16_t y, uint8_t width, uint8_t height, int32_t max);
+
+// the buffers are not owned by the widget, eg. from asset_get_icon
+UiWidget *ui_add_icon(UiLayer *ui, Buffer *sprite, Buffer *mask, int16_t x, int16_t y);
+
+UiWidget *ui_add_custom(UiLayer *ui, int16_t x, int16_t y, uint8_t width, uint8_t height,
+                        void (*draw)(Buffer *target, UiWidget *widget, void *context), void *context);
+
+// the setters only invalidate the widget when the value actually changes, so they can be called every frame
+void ui_set_text(UiWidget *widget, const char *text);
+
+void ui_set_number(UiWidget *widget, int32_t value);
+
+void ui_set_value(UiWidget *widget, int32_t value);
+
+void ui_set_visible(UiWidget *widget, bool visible);
+
+void ui_set_color(UiWidget *widget, PixelColor color);
+
+void ui_move(UiWidget *widget, int16_t x, int16_t y);
+
+// redraws the widget on the next update, eg. after a custom widget changed its own state
+void ui_invalidate(UiWidget *widget);
+
+// redraws the invalidated widgets into the cache, returns the number of redrawn areas
+uint8_t ui_update(UiLayer *ui);
+
+// ui_update followed by the composite into target
+void ui_render(UiLayer *ui, Buffer *target);
@@ -0,0 +1,40 @@
+#include "bounds.h"
+
+bool bounds_is_empty(Bounds *const bounds) {
+    return bounds->min.x > bounds->max.x || bounds->min.y > bounds->max.y;
+}
+
+bool bounds_is_infinite(Bounds *const bounds) {
+    return bounds->min.x == -FLT_MAX || bounds->min.y == -FLT_MAX ||
+           bounds->max.x == FLT_MAX || bounds->max.y == FLT_MAX;
+}
+
+void bounds_add_point(Bounds *bounds, Vector *const point) {
+    bounds->min.x = MIN(bounds->min.x, point->x);
+    bounds->min.y = MIN(bounds->min.y, point->y);
+    bounds->max.x = MAX(bounds->max.x, point->x);
+    bounds->max.y = MAX(bounds->max.y, point->y);
+}
+
+void bounds_merge(Bounds *bounds, Bounds *const other) {
+    if (bounds_is_empty(other)) return;
+    bounds_add_point(bounds, &(other->min));
+    bounds_add_point(bounds, &(other->max));
+}
+
+bool bounds_overlaps(Bounds *const a, Bounds *const b) {
+    return a->min.x <= b->max.x && a->max.x >= b->min.x &&
+           a->min.y <= b->max.y && a->max.y >= b->min.y;
+}
+
+bool bounds_equals(Bounds *const a, Bounds *const b) {
+    return a->min.x == b->min.x && a->min.y == b->min.y &&
+           a->max.x == b->max.x && a->max.y == b->max.y;
+}
+
+float bounds_distance(Bounds *const a, Bounds *const b) {
+    if (bounds_is_empty(a) || bounds_is_empty(b)) return 0;
+    float dx = MAX(a->min.x - b->max.x, b->min.x - a->max.x);
+    float dy = MAX(a->min.y - b->max.y, b->min.y - a->max.y);
+    return MAX(0, MAX(dx, dy));
+}
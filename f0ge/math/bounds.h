@@ -0,0 +1,29 @@
+#pragma once
+#include <float.h>
+#include "vector.h"
+
+typedef struct Bounds Bounds;
+
+// axis aligned bounding box, an empty box has min > max
+struct Bounds {
+    Vector min;
+    Vector max;
+};
+
+#define BOUNDS_EMPTY (Bounds){.min={FLT_MAX, FLT_MAX}, .max={-FLT_MAX, -FLT_MAX}}
+#define BOUNDS_INFINITE (Bounds){.min={-FLT_MAX, -FLT_MAX}, .max={FLT_MAX, FLT_MAX}}
+
+bool bounds_is_empty(Bounds *const bounds);
+
+bool bounds_is_infinite(Bounds *const bounds);
+
+void bounds_add_point(Bounds *bounds, Vector *const point);
+
+void bounds_merge(Bounds *bounds, Bounds *const other);
+
+bool bounds_overlaps(Bounds *const a, Bounds *const b);
+
+bool bounds_equals(Bounds *const a, Bounds *const b);
+
+// largest gap between the boxes along either axis, 0 if they overlap or one of them is empty
+float bounds_distance(Bounds *const a, Bounds *const b);
@@ -0,0 +1,76 @@
+#pragma once
+#include <furi.h>
+
+// Q16.16 fixed point numbers: 16 integer bits (-32768..32767) and 16 fraction bits.
+// Build with F0GE_FIXED_POINT to run the raster hot paths (triangle setup and stepping) on these instead of
+// floats, filled polygons and mesh coverage use the snapped integer edges in every build. Positions, transforms
+// and the rest of the api stay float, values are converted once per triangle or shape. The integer paths give
+// the same pixels on every build and need no float to int casts.
+// The arithmetic saturates instead of wrapping, so far off-screen geometry clamps rather than flipping sign.
+
+typedef int32_t fixed;
+
+#define FX_SHIFT 16
+#define FX_ONE ((fixed) 1 << FX_SHIFT)
+#define FX_HALF ((fixed) 1 << (FX_SHIFT - 1))
+#define FX_FRACTION (FX_ONE - 1)
+#define FX_MAX INT32_MAX
+#define FX_MIN INT32_MIN
+
+static inline fixed fx_saturate(int64_t value) {
+    if (value > FX_MAX) return FX_MAX;
+    if (value < FX_MIN) return FX_MIN;
+    return (fixed) value;
+}
+
+static inline fixed fx_from_float(float value) {
+    return fx_saturate((int64_t) (value * (float) FX_ONE));
+}
+
+static inline float fx_to_float(fixed value) {
+    return (float) value / (float) FX_ONE;
+}
+
+static inline fixed fx_from_int(int32_t value) {
+    return fx_saturate((int64_t) value << FX_SHIFT);
+}
+
+// the shifts round towards -infinity, also for negative values
+static inline int32_t fx_floor(fixed value) {
+    return value >> FX_SHIFT;
+}
+
+static inline int32_t fx_ceil(fixed value) {
+    return (int32_t) (((int64_t) value + FX_FRACTION) >> FX_SHIFT);
+}
+
+static inline int32_t fx_round(fixed value) {
+    return (int32_t) (((int64_t) value + FX_HALF) >> FX_SHIFT);
+}
+
+static inline fixed fx_add(fixed a, fixed b) {
+    return fx_saturate((int64_t) a + b);
+}
+
+static inline fixed fx_sub(fixed a, fixed b) {
+    return fx_saturate((int64_t) a - b);
+}
+
+static inline fixed fx_mul(fixed a, fixed b) {
+    return fx_saturate(((int64_t) a * b) >> FX_SHIFT);
+}
+
+// division by zero gives the largest value with the sign of a
+static inline fixed fx_div(fixed a, fixed b) {
+    if (b == 0) return a < 0 ? FX_MIN : FX_MAX;
+    return fx_saturate(((int64_t) a << FX_SHIFT) / b);
+}
+
+// Rasterizers snap vertices to 1/16 pixel: edge products of on-screen and far off-screen geometry then fit
+// in 64 bits exactly, and every shape that shares a vertex sees the same point.
+#define FX_SUBPIXEL_BITS 4
+#define FX_SUBPIXEL_ONE (1 << FX_SUBPIXEL_BITS)
+
+static inline int32_t fx_subpixel(float value) {
+    return fx_from_float(value) >> (FX_SHIFT - FX_SUBPIXEL_BITS);
+}
@@ -45,12 +45,13 @@ void matrix_translate(Vector *translate, Matrix *target) {
 }
 
 void matrix_rotate(float angle, Matrix *target) {
-    (*target)[0] = cosf(angle);
-    (*target)[1] = -sinf(angle);
+    const float s = sinf(angle), c = cosf(angle);
+    (*target)[0] = c;
+    (*target)[1] = -s;
     (*target)[2] = 0;
 
-    (*target)[3] = sinf(angle);
-    (*target)[4] = cosf(angle);
+    (*target)[3] = s;
+    (*target)[4] = c;
     (*target)[5] = 0;
 
     (*target)[6] = 0;
@@ -86,33 +87,49 @@ float matrix_get_rotation(Matrix *a) {
     return atan2f((*a)[3], (*a)[4]);
 }
 
+void matrix_get_sincos(Matrix *a, float *sine, float *cosine) {
+    const float length = sqrtf((*a)[3] * (*a)[3] + (*a)[4] * (*a)[4]);
+    if (length == 0) {
+        *sine = 0;
+        *cosine = 1;
+        return;
+    }
+    *sine = (*a)[3] / length;
+    *cosine = (*a)[4] / length;
+}
+
 void matrix_get_scaling(Matrix *data, Vector *target) {
     target->x = sqrtf((*data)[0] * (*data)[0] + (*data)[1] * (*data)[1]);
     target->y = sqrtf((*data)[3] * (*data)[3] + (*data)[4] * (*data)[4]);
 }
 
-static Matrix scale_matrix, rotation_matrix, translation_matrix;
-
 void compute_transformation_matrix(Transform *target, Transform *parent) {
-    // Apply scaling
-    matrix_scale(&(target->scale), &scale_matrix);
+    // the sin/cos pair of the last rotation is kept, moving or scaling a node costs no trig
+    if (target->_rotation != target->rotation || (target->_sin == 0 && target->_cos == 0)) {
+        trig_sincos_degrees(target->rotation, &(target->_sin), &(target->_cos));
+        target->_rotation = target->rotation;
+    }
+    const float s = target->_sin, c = target->_cos;
 
-    // Apply rotation
-    matrix_rotate(target->rotation * DEG_2_RAD, &rotation_matrix);
+    // translation * rotation * scale written out, first scale, then rotate, finally translate
+    Matrix *m = &(target->transformation_matrix);
+    (*m)[0] = c * target->scale.x;
+    (*m)[1] = -s * target->scale.y;
+    (*m)[2] = target->position.x;
 
-    // Apply translation
-    matrix_translate(&(target->position), &translation_matrix);
+    (*m)[3] = s * target->scale.x;
+    (*m)[4] = c * target->scale.y;
+    (*m)[5] = target->position.y;
 
-    // Correct order: First scale, then rotate, finally translate
-    // Combine transformations
-    Matrix temp_matrix;
-    matrix_mul(&translation_matrix, &rotation_matrix, &temp_matrix); // Rotate and then scale
-    matrix_mul(&temp_matrix, &scale_matrix, &(target->transformation_matrix)); // Apply translation after
+    (*m)[6] = 0;
+    (*m)[7] = 0;
+    (*m)[8] = 1;
 
     //Apply relative transform from parent node
     if (parent) {
-        matrix_mul(&(parent->transformation_matrix), &(target->transformation_matrix), &temp_matrix);
-        matrix_copy(&temp_matrix, &(target->transformation_matrix));
+        Matrix temp_matrix;
+        matrix_mul(&(parent->transformation_matrix), m, &temp_matrix);
+        matrix_copy(&temp_matrix, m);
     }
 }
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "vector.h"
+#include "trig.h"
 typedef float Matrix[9];
 typedef struct Transform Transform;
 
@@ -11,6 +12,9 @@ typedef struct Transform Transform;
     .scale={1,1}, \
     .position={0,0}, \
     .rotation=0, \
+    ._rotation=0, \
+    ._sin=0, \
+    ._cos=1, \
     .transformation_matrix=IDENTITY_MATRIX \
 }
 
@@ -19,6 +23,10 @@ struct Transform {
     Vector scale;
     Vector position;
     float rotation;
+    //sin and cos of _rotation (degrees), recomputed only when rotation changes. all zero means not cached yet
+    float _rotation;
+    float _sin;
+    float _cos;
 
     Matrix transformation_matrix;
 };
@@ -42,6 +50,9 @@ void matrix_get_translation(Matrix *a, Vector *translation);
 
 float matrix_get_rotation(Matrix *a);
 
+// sin and cos of the rotation without the angle, the rotation column normalized
+void matrix_get_sincos(Matrix *a, float *sine, float *cosine);
+
 void matrix_get_scaling(Matrix *a, Vector *target);
 
 void matrix_forward(Matrix *a, Vector *target);
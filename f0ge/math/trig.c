@@ -0,0 +1,74 @@
+#include "trig.h"
+#include "equation.h"
+
+// bits of an angle inside a quadrant below the table index, they are the interpolation weight
+#define TRIG_FRACTION_BITS (14 - TRIG_TABLE_BITS)
+#define TRIG_FRACTION_MASK ((1 << TRIG_FRACTION_BITS) - 1)
+
+static inline Angle angle_from_turns(float turns) {
+    //the cast truncates, the wrap to 16 bits happens in the integer
+    return (Angle) (int32_t) (turns < 0 ? turns - 0.5f : turns + 0.5f);
+}
+
+Angle angle_from_degrees(float degrees) {
+    return angle_from_turns(degrees * (ANGLE_TURN / 360.0f));
+}
+
+Angle angle_from_radians(float radians) {
+    return angle_from_turns(radians * (float) (ANGLE_TURN / M_PIX2));
+}
+
+float angle_to_degrees(Angle angle) {
+    return angle * (360.0f / ANGLE_TURN);
+}
+
+void trig_sincos(Angle angle, float *sine, float *cosine) {
+    const uint16_t offset = angle & (ANGLE_QUARTER - 1);
+    const uint16_t index = offset >> TRIG_FRACTION_BITS;
+    const float t = (offset & TRIG_FRACTION_MASK) * (1.0f / (1 << TRIG_FRACTION_BITS));
+    const float *table = trig_sine_table;
+
+    //the cosine in the quadrant is the sine read backwards
+    const float s = table[index] + (table[index + 1] - table[index]) * t;
+    const float c = table[TRIG_TABLE_SIZE - index] +
+                    (table[TRIG_TABLE_SIZE - index - 1] - table[TRIG_TABLE_SIZE - index]) * t;
+
+    switch (angle >> 14) {
+        case 0:
+            *sine = s;
+            *cosine = c;
+            break;
+        case 1:
+            *sine = c;
+            *cosine = -s;
+            break;
+        case 2:
+            *sine = -s;
+            *cosine = -c;
+            break;
+        default:
+            *sine = -c;
+            *cosine = s;
+            break;
+    }
+}
+
+float trig_sin(Angle angle) {
+    float sine, cosine;
+    trig_sincos(angle, &sine, &cosine);
+    return sine;
+}
+
+float trig_cos(Angle angle) {
+    return trig_sin(angle + ANGLE_QUARTER);
+}
+
+void trig_sincos_degrees(float degrees, float *sine, float *cosine) {
+#ifdef F0GE_FAST_TRIG
+    trig_sincos(angle_from_degrees(degrees), sine, cosine);
+#else
+    const float radians = degrees * DEG_2_RAD;
+    *sine = sinf(radians);
+    *cosine = cosf(radians);
+#endif
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <furi.h>
+
+// Binary angles and a table based sincos.
+// An Angle is a fraction of a full turn in 16 bits, it wraps around by itself and quantizes rotations to
+// 1/65536 of a turn (0.0055 degrees). trig_sincos interpolates a quarter wave table, the table has
+// 2^TRIG_TABLE_BITS steps (6, 8 or 10, see tools/trig/trig_table.py), 8 is off by less than 5e-6.
+// trig_sincos_degrees is what the engine calls for rotations: libm by default, the table with F0GE_FAST_TRIG.
+
+typedef uint16_t Angle;
+
+#define ANGLE_TURN 65536
+#define ANGLE_QUARTER (ANGLE_TURN / 4)
+
+#ifndef TRIG_TABLE_BITS
+#define TRIG_TABLE_BITS 8
+#endif
+#define TRIG_TABLE_SIZE (1 << TRIG_TABLE_BITS)
+
+extern const float trig_sine_table[TRIG_TABLE_SIZE + 1];
+
+// rounded to the nearest step, any number of turns in either direction (up to about 10^7 degrees)
+Angle angle_from_degrees(float degrees);
+
+Angle angle_from_radians(float radians);
+
+float angle_to_degrees(Angle angle);
+
+void trig_sincos(Angle angle, float *sine, float *cosine);
+
+float trig_sin(Angle angle);
+
+float trig_cos(Angle angle);
+
+void trig_sincos_degrees(float degrees, float *sine, float *cosine);
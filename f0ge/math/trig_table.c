@@ -0,0 +1,240 @@
+// generated by tools/trig/trig_table.py, do not edit
+#include "trig.h"
+
+#if TRIG_TABLE_BITS == 6
+const float trig_sine_table[TRIG_TABLE_SIZE + 1] = {
+    0.000000000f, 0.024541229f, 0.049067674f, 0.073564564f, 0.098017140f, 0.122410675f,
+    0.146730474f, 0.170961889f, 0.195090322f, 0.219101240f, 0.242980180f, 0.266712757f,
+    0.290284677f, 0.313681740f, 0.336889853f, 0.359895037f, 0.382683432f, 0.405241314f,
+    0.427555093f, 0.449611330f, 0.471396737f, 0.492898192f, 0.514102744f, 0.534997620f,
+    0.555570233f, 0.575808191f, 0.595699304f, 0.615231591f, 0.634393284f, 0.653172843f,
+    0.671558955f, 0.689540545f, 0.707106781f, 0.724247083f, 0.740951125f, 0.757208847f,
+    0.773010453f, 0.788346428f, 0.803207531f, 0.817584813f, 0.831469612f, 0.844853565f,
+    0.857728610f, 0.870086991f, 0.881921264f, 0.893224301f, 0.903989293f, 0.914209756f,
+    0.923879533f, 0.932992799f, 0.941544065f, 0.949528181f, 0.956940336f, 0.963776066f,
+    0.970031253f, 0.975702130f, 0.980785280f, 0.985277642f, 0.989176510f, 0.992479535f,
+    0.995184727f, 0.997290457f, 0.998795456f, 0.999698819f, 1.000000000f,
+};
+#elif TRIG_TABLE_BITS == 8
+const float trig_sine_table[TRIG_TABLE_SIZE + 1] = {
+    0.000000000f, 0.006135885f, 0.012271538f, 0.018406730f, 0.024541229f, 0.030674803f,
+    0.036807223f, 0.042938257f, 0.049067674f, 0.055195244f, 0.061320736f, 0.067443920f,
+    0.073564564f, 0.079682438f, 0.085797312f, 0.091908956f, 0.098017140f, 0.104121634f,
+    0.110222207f, 0.116318631f, 0.122410675f, 0.128498111f, 0.134580709f, 0.140658239f,
+    0.146730474f, 0.152797185f, 0.158858143f, 0.164913120f, 0.170961889f, 0.177004220f,
+    0.183039888f, 0.189068664f, 0.195090322f, 0.201104635f, 0.207111376f, 0.213110320f,
+    0.219101240f, 0.225083911f, 0.231058108f, 0.237023606f, 0.242980180f, 0.248927606f,
+    0.254865660f, 0.260794118f, 0.266712757f, 0.272621355f, 0.278519689f, 0.284407537f,
+    0.290284677f, 0.296150888f, 0.302005949f, 0.307849640f, 0.313681740f, 0.319502031f,
+    0.325310292f, 0.331106306f, 0.336889853f, 0.342660717f, 0.348418680f, 0.354163525f,
+    0.359895037f, 0.365612998f, 0.371317194f, 0.377007410f, 0.382683432f, 0.388345047f,
+    0.393992040f, 0.399624200f, 0.405241314f, 0.410843171f, 0.416429560f, 0.422000271f,
+    0.427555093f, 0.433093819f, 0.438616239f, 0.444122145f, 0.449611330f, 0.455083587f,
+    0.460538711f, 0.465976496f, 0.471396737f, 0.476799230f, 0.482183772f, 0.487550160f,
+    0.492898192f, 0.498227667f, 0.503538384f, 0.508830143f, 0.514102744f, 0.519355990f,
+    0.524589683f, 0.529803625f, 0.534997620f, 0.540171473f, 0.545324988f, 0.550457973f,
+    0.555570233f, 0.560661576f, 0.565731811f, 0.570780746f, 0.575808191f, 0.580813958f,
+    0.585797857f, 0.590759702f, 0.595699304f, 0.600616479f, 0.605511041f, 0.610382806f,
+    0.615231591f, 0.620057212f, 0.624859488f, 0.629638239f, 0.634393284f, 0.639124445f,
+    0.643831543f, 0.648514401f, 0.653172843f, 0.657806693f, 0.662415778f, 0.666999922f,
+    0.671558955f, 0.676092704f, 0.680600998f, 0.685083668f, 0.689540545f, 0.693971461f,
+    0.698376249f, 0.702754744f, 0.707106781f, 0.711432196f, 0.715730825f, 0.720002508f,
+    0.724247083f, 0.728464390f, 0.732654272f, 0.736816569f, 0.740951125f, 0.745057785f,
+    0.749136395f, 0.753186799f, 0.757208847f, 0.761202385f, 0.765167266f, 0.769103338f,
+    0.773010453f, 0.776888466f, 0.780737229f, 0.784556597f, 0.788346428f, 0.792106577f,
+    0.795836905f, 0.799537269f, 0.803207531f, 0.806847554f, 0.810457198f, 0.814036330f,
+    0.817584813f, 0.821102515f, 0.824589303f, 0.828045045f, 0.831469612f, 0.834862875f,
+    0.838224706f, 0.841554977f, 0.844853565f, 0.848120345f, 0.851355193f, 0.854557988f,
+    0.857728610f, 0.860866939f, 0.863972856f, 0.867046246f, 0.870086991f, 0.873094978f,
+    0.876070094f, 0.879012226f, 0.881921264f, 0.884797098f, 0.887639620f, 0.890448723f,
+    0.893224301f, 0.895966250f, 0.898674466f, 0.901348847f, 0.903989293f, 0.906595705f,
+    0.909167983f, 0.911706032f, 0.914209756f, 0.916679060f, 0.919113852f, 0.921514039f,
+    0.923879533f, 0.926210242f, 0.928506080f, 0.930766961f, 0.932992799f, 0.935183510f,
+    0.937339012f, 0.939459224f, 0.941544065f, 0.943593458f, 0.945607325f, 0.947585591f,
+    0.949528181f, 0.951435021f, 0.953306040f, 0.955141168f, 0.956940336f, 0.958703475f,
+    0.960430519f, 0.962121404f, 0.963776066f, 0.965394442f, 0.966976471f, 0.968522094f,
+    0.970031253f, 0.971503891f, 0.972939952f, 0.974339383f, 0.975702130f, 0.977028143f,
+    0.978317371f, 0.979569766f, 0.980785280f, 0.981963869f, 0.983105487f, 0.984210092f,
+    0.985277642f, 0.986308097f, 0.987301418f, 0.988257568f, 0.989176510f, 0.990058210f,
+    0.990902635f, 0.991709754f, 0.992479535f, 0.993211949f, 0.993906970f, 0.994564571f,
+    0.995184727f, 0.995767414f, 0.996312612f, 0.996820299f, 0.997290457f, 0.997723067f,
+    0.998118113f, 0.998475581f, 0.998795456f, 0.999077728f, 0.999322385f, 0.999529418f,
+    0.999698819f, 0.999830582f, 0.999924702f, 0.999981175f, 1.000000000f,
+};
+#elif TRIG_TABLE_BITS == 10
+const float trig_sine_table[TRIG_TABLE_SIZE + 1] = {
+    0.000000000f, 0.001533980f, 0.003067957f, 0.004601926f, 0.006135885f, 0.007669829f,
+    0.009203755f, 0.010737659f, 0.012271538f, 0.013805389f, 0.015339206f, 0.016872988f,
+    0.018406730f, 0.019940429f, 0.021474080f, 0.023007681f, 0.024541229f, 0.026074718f,
+    0.027608146f, 0.029141509f, 0.030674803f, 0.032208025f, 0.033741172f, 0.035274239f,
+    0.036807223f, 0.038340120f, 0.039872928f, 0.041405641f, 0.042938257f, 0.044470772f,
+    0.046003182f, 0.047535484f, 0.049067674f, 0.050599749f, 0.052131705f, 0.053663538f,
+    0.055195244f, 0.056726821f, 0.058258265f, 0.059789571f, 0.061320736f, 0.062851758f,
+    0.064382631f, 0.065913353f, 0.067443920f, 0.068974328f, 0.070504573f, 0.072034653f,
+    0.073564564f, 0.075094301f, 0.076623861f, 0.078153242f, 0.079682438f, 0.081211447f,
+    0.082740265f, 0.084268888f, 0.085797312f, 0.087325535f, 0.088853553f, 0.090381361f,
+    0.091908956f, 0.093436336f, 0.094963495f, 0.096490431f, 0.098017140f, 0.099543619f,
+    0.101069863f, 0.102595869f, 0.104121634f, 0.105647154f, 0.107172425f, 0.108697444f,
+    0.110222207f, 0.111746711f, 0.113270952f, 0.114794927f, 0.116318631f, 0.117842062f,
+    0.119365215f, 0.120888087f, 0.122410675f, 0.123932975f, 0.125454983f, 0.126976696f,
+    0.128498111f, 0.130019223f, 0.131540029f, 0.133060525f, 0.134580709f, 0.136100575f,
+    0.137620122f, 0.139139344f, 0.140658239f, 0.142176804f, 0.143695033f, 0.145212925f,
+    0.146730474f, 0.148247679f, 0.149764535f, 0.151281038f, 0.152797185f, 0.154312973f,
+    0.155828398f, 0.157343456f, 0.158858143f, 0.160372457f, 0.161886394f, 0.163399949f,
+    0.164913120f, 0.166425904f, 0.167938295f, 0.169450291f, 0.170961889f, 0.172473084f,
+    0.173983873f, 0.175494253f, 0.177004220f, 0.178513771f, 0.180022901f, 0.181531608f,
+    0.183039888f, 0.184547737f, 0.186055152f, 0.187562129f, 0.189068664f, 0.190574755f,
+    0.192080397f, 0.193585587f, 0.195090322f, 0.196594598f, 0.198098411f, 0.199601758f,
+    0.201104635f, 0.202607039f, 0.204108966f, 0.205610413f, 0.207111376f, 0.208611852f,
+    0.210111837f, 0.211611327f, 0.213110320f, 0.214608811f, 0.216106797f, 0.217604275f,
+    0.219101240f, 0.220597690f, 0.222093621f, 0.223589029f, 0.225083911f, 0.226578264f,
+    0.228072083f, 0.229565366f, 0.231058108f, 0.232550307f, 0.234041959f, 0.235533059f,
+    0.237023606f, 0.238513595f, 0.240003022f, 0.241491885f, 0.242980180f, 0.244467903f,
+    0.245955050f, 0.247441619f, 0.248927606f, 0.250413007f, 0.251897818f, 0.253382037f,
+    0.254865660f, 0.256348682f, 0.257831102f, 0.259312915f, 0.260794118f, 0.262274707f,
+    0.263754679f, 0.265234030f, 0.266712757f, 0.268190857f, 0.269668326f, 0.271145160f,
+    0.272621355f, 0.274096910f, 0.275571819f, 0.277046080f, 0.278519689f, 0.279992643f,
+    0.281464938f, 0.282936570f, 0.284407537f, 0.285877835f, 0.287347460f, 0.288816408f,
+    0.290284677f, 0.291752263f, 0.293219163f, 0.294685372f, 0.296150888f, 0.297615707f,
+    0.299079826f, 0.300543241f, 0.302005949f, 0.303467947f, 0.304929230f, 0.306389795f,
+    0.307849640f, 0.309308760f, 0.310767153f, 0.312224814f, 0.313681740f, 0.315137929f,
+    0.316593376f, 0.318048077f, 0.319502031f, 0.320955232f, 0.322407679f, 0.323859367f,
+    0.325310292f, 0.326760452f, 0.328209844f, 0.329658463f, 0.331106306f, 0.332553370f,
+    0.333999651f, 0.335445147f, 0.336889853f, 0.338333767f, 0.339776884f, 0.341219202f,
+    0.342660717f, 0.344101426f, 0.345541325f, 0.346980411f, 0.348418680f, 0.349856130f,
+    0.351292756f, 0.352728556f, 0.354163525f, 0.355597662f, 0.357030961f, 0.358463421f,
+    0.359895037f, 0.361325806f, 0.362755724f, 0.364184790f, 0.365612998f, 0.367040346f,
+    0.368466830f, 0.369892447f, 0.371317194f, 0.372741067f, 0.374164063f, 0.375586178f,
+    0.377007410f, 0.378427755f, 0.379847209f, 0.381265769f, 0.382683432f, 0.384100195f,
+    0.385516054f, 0.386931006f, 0.388345047f, 0.389758174f, 0.391170384f, 0.392581674f,
+    0.393992040f, 0.395401479f, 0.396809987f, 0.398217562f, 0.399624200f, 0.401029897f,
+    0.402434651f, 0.403838458f, 0.405241314f, 0.406643217f, 0.408044163f, 0.409444149f,
+    0.410843171f, 0.412241227f, 0.413638312f, 0.415034424f, 0.416429560f, 0.417823716f,
+    0.419216888f, 0.420609074f, 0.422000271f, 0.423390474f, 0.424779681f, 0.426167889f,
+    0.427555093f, 0.428941292f, 0.430326481f, 0.431710658f, 0.433093819f, 0.434475961f,
+    0.435857080f, 0.437237174f, 0.438616239f, 0.439994271f, 0.441371269f, 0.442747228f,
+    0.444122145f, 0.445496017f, 0.446868840f, 0.448240612f, 0.449611330f, 0.450980989f,
+    0.452349587f, 0.453717121f, 0.455083587f, 0.456448982f, 0.457813304f, 0.459176548f,
+    0.460538711f, 0.461899791f, 0.463259784f, 0.464618686f, 0.465976496f, 0.467333209f,
+    0.468688822f, 0.470043332f, 0.471396737f, 0.472749032f, 0.474100215f, 0.475450282f,
+    0.476799230f, 0.478147056f, 0.479493758f, 0.480839331f, 0.482183772f, 0.483527079f,
+    0.484869248f, 0.486210276f, 0.487550160f, 0.488888897f, 0.490226483f, 0.491562916f,
+    0.492898192f, 0.494232309f, 0.495565262f, 0.496897049f, 0.498227667f, 0.499557113f,
+    0.500885383f, 0.502212474f, 0.503538384f, 0.504863109f, 0.506186645f, 0.507508991f,
+    0.508830143f, 0.510150097f, 0.511468850f, 0.512786401f, 0.514102744f, 0.515417878f,
+    0.516731799f, 0.518044504f, 0.519355990f, 0.520666254f, 0.521975293f, 0.523283103f,
+    0.524589683f, 0.525895027f, 0.527199135f, 0.528502002f, 0.529803625f, 0.531104001f,
+    0.532403128f, 0.533701002f, 0.534997620f, 0.536292979f, 0.537587076f, 0.538879909f,
+    0.540171473f, 0.541461766f, 0.542750785f, 0.544038527f, 0.545324988f, 0.546610167f,
+    0.547894059f, 0.549176662f, 0.550457973f, 0.551737988f, 0.553016706f, 0.554294121f,
+    0.555570233f, 0.556845037f, 0.558118531f, 0.559390712f, 0.560661576f, 0.561931121f,
+    0.563199344f, 0.564466242f, 0.565731811f, 0.566996049f, 0.568258953f, 0.569520519f,
+    0.570780746f, 0.572039629f, 0.573297167f, 0.574553355f, 0.575808191f, 0.577061673f,
+    0.578313796f, 0.579564559f, 0.580813958f, 0.582061990f, 0.583308653f, 0.584553943f,
+    0.585797857f, 0.587040394f, 0.588281548f, 0.589521319f, 0.590759702f, 0.591996695f,
+    0.593232295f, 0.594466499f, 0.595699304f, 0.596930708f, 0.598160707f, 0.599389298f,
+    0.600616479f, 0.601842247f, 0.603066599f, 0.604289531f, 0.605511041f, 0.606731127f,
+    0.607949785f, 0.609167012f, 0.610382806f, 0.611597164f, 0.612810082f, 0.614021559f,
+    0.615231591f, 0.616440175f, 0.617647308f, 0.618852988f, 0.620057212f, 0.621259977f,
+    0.622461279f, 0.623661118f, 0.624859488f, 0.626056388f, 0.627251815f, 0.628445767f,
+    0.629638239f, 0.630829230f, 0.632018736f, 0.633206755f, 0.634393284f, 0.635578320f,
+    0.636761861f, 0.637943904f, 0.639124445f, 0.640303482f, 0.641481013f, 0.642657034f,
+    0.643831543f, 0.645004537f, 0.646176013f, 0.647345969f, 0.648514401f, 0.649681307f,
+    0.650846685f, 0.652010531f, 0.653172843f, 0.654333618f, 0.655492853f, 0.656650546f,
+    0.657806693f, 0.658961293f, 0.660114342f, 0.661265838f, 0.662415778f, 0.663564159f,
+    0.664710978f, 0.665856234f, 0.666999922f, 0.668142041f, 0.669282588f, 0.670421560f,
+    0.671558955f, 0.672694769f, 0.673829000f, 0.674961646f, 0.676092704f, 0.677222170f,
+    0.678350043f, 0.679476320f, 0.680600998f, 0.681724074f, 0.682845546f, 0.683965412f,
+    0.685083668f, 0.686200312f, 0.687315341f, 0.688428753f, 0.689540545f, 0.690650714f,
+    0.691759258f, 0.692866175f, 0.693971461f, 0.695075114f, 0.696177131f, 0.697277511f,
+    0.698376249f, 0.699473345f, 0.700568794f, 0.701662595f, 0.702754744f, 0.703845241f,
+    0.704934080f, 0.706021261f, 0.707106781f, 0.708190637f, 0.709272826f, 0.710353347f,
+    0.711432196f, 0.712509371f, 0.713584869f, 0.714658688f, 0.715730825f, 0.716801279f,
+    0.717870045f, 0.718937122f, 0.720002508f, 0.721066199f, 0.722128194f, 0.723188489f,
+    0.724247083f, 0.725303972f, 0.726359155f, 0.727412629f, 0.728464390f, 0.729514438f,
+    0.730562769f, 0.731609381f, 0.732654272f, 0.733697438f, 0.734738878f, 0.735778589f,
+    0.736816569f, 0.737852815f, 0.738887324f, 0.739920095f, 0.740951125f, 0.741980412f,
+    0.743007952f, 0.744033744f, 0.745057785f, 0.746080074f, 0.747100606f, 0.748119380f,
+    0.749136395f, 0.750151646f, 0.751165132f, 0.752176850f, 0.753186799f, 0.754194975f,
+    0.755201377f, 0.756206001f, 0.757208847f, 0.758209910f, 0.759209189f, 0.760206682f,
+    0.761202385f, 0.762196298f, 0.763188417f, 0.764178741f, 0.765167266f, 0.766153990f,
+    0.767138912f, 0.768122029f, 0.769103338f, 0.770082837f, 0.771060524f, 0.772036397f,
+    0.773010453f, 0.773982691f, 0.774953107f, 0.775921699f, 0.776888466f, 0.777853404f,
+    0.778816512f, 0.779777788f, 0.780737229f, 0.781694832f, 0.782650596f, 0.783604519f,
+    0.784556597f, 0.785506830f, 0.786455214f, 0.787401747f, 0.788346428f, 0.789289253f,
+    0.790230221f, 0.791169330f, 0.792106577f, 0.793041960f, 0.793975478f, 0.794907126f,
+    0.795836905f, 0.796764810f, 0.797690841f, 0.798614995f, 0.799537269f, 0.800457662f,
+    0.801376172f, 0.802292796f, 0.803207531f, 0.804120377f, 0.805031331f, 0.805940391f,
+    0.806847554f, 0.807752818f, 0.808656182f, 0.809557642f, 0.810457198f, 0.811354847f,
+    0.812250587f, 0.813144415f, 0.814036330f, 0.814926329f, 0.815814411f, 0.816700573f,
+    0.817584813f, 0.818467130f, 0.819347520f, 0.820225983f, 0.821102515f, 0.821977115f,
+    0.822849781f, 0.823720511f, 0.824589303f, 0.825456154f, 0.826321063f, 0.827184027f,
+    0.828045045f, 0.828904115f, 0.829761234f, 0.830616400f, 0.831469612f, 0.832320868f,
+    0.833170165f, 0.834017501f, 0.834862875f, 0.835706284f, 0.836547727f, 0.837387202f,
+    0.838224706f, 0.839060237f, 0.839893794f, 0.840725375f, 0.841554977f, 0.842382600f,
+    0.843208240f, 0.844031895f, 0.844853565f, 0.845673247f, 0.846490939f, 0.847306639f,
+    0.848120345f, 0.848932055f, 0.849741768f, 0.850549481f, 0.851355193f, 0.852158902f,
+    0.852960605f, 0.853760301f, 0.854557988f, 0.855353665f, 0.856147328f, 0.856938977f,
+    0.857728610f, 0.858516224f, 0.859301818f, 0.860085390f, 0.860866939f, 0.861646461f,
+    0.862423956f, 0.863199422f, 0.863972856f, 0.864744258f, 0.865513624f, 0.866280954f,
+    0.867046246f, 0.867809497f, 0.868570706f, 0.869329871f, 0.870086991f, 0.870842063f,
+    0.871595087f, 0.872346059f, 0.873094978f, 0.873841843f, 0.874586652f, 0.875329403f,
+    0.876070094f, 0.876808724f, 0.877545290f, 0.878279792f, 0.879012226f, 0.879742593f,
+    0.880470889f, 0.881197113f, 0.881921264f, 0.882643340f, 0.883363339f, 0.884081259f,
+    0.884797098f, 0.885510856f, 0.886222530f, 0.886932119f, 0.887639620f, 0.888345033f,
+    0.889048356f, 0.889749586f, 0.890448723f, 0.891145765f, 0.891840709f, 0.892533555f,
+    0.893224301f, 0.893912945f, 0.894599486f, 0.895283921f, 0.895966250f, 0.896646470f,
+    0.897324581f, 0.898000580f, 0.898674466f, 0.899346237f, 0.900015892f, 0.900683429f,
+    0.901348847f, 0.902012144f, 0.902673318f, 0.903332368f, 0.903989293f, 0.904644091f,
+    0.905296759f, 0.905947298f, 0.906595705f, 0.907241978f, 0.907886116f, 0.908528119f,
+    0.909167983f, 0.909805708f, 0.910441292f, 0.911074734f, 0.911706032f, 0.912335185f,
+    0.912962190f, 0.913587048f, 0.914209756f, 0.914830312f, 0.915448716f, 0.916064966f,
+    0.916679060f, 0.917290997f, 0.917900776f, 0.918508394f, 0.919113852f, 0.919717146f,
+    0.920318277f, 0.920917242f, 0.921514039f, 0.922108669f, 0.922701128f, 0.923291417f,
+    0.923879533f, 0.924465474f, 0.925049241f, 0.925630831f, 0.926210242f, 0.926787474f,
+    0.927362526f, 0.927935395f, 0.928506080f, 0.929074581f, 0.929640896f, 0.930205023f,
+    0.930766961f, 0.931326709f, 0.931884266f, 0.932439629f, 0.932992799f, 0.933543773f,
+    0.934092550f, 0.934639130f, 0.935183510f, 0.935725689f, 0.936265667f, 0.936803442f,
+    0.937339012f, 0.937872376f, 0.938403534f, 0.938932484f, 0.939459224f, 0.939983753f,
+    0.940506071f, 0.941026175f, 0.941544065f, 0.942059740f, 0.942573198f, 0.943084437f,
+    0.943593458f, 0.944100258f, 0.944604837f, 0.945107193f, 0.945607325f, 0.946105232f,
+    0.946600913f, 0.947094366f, 0.947585591f, 0.948074586f, 0.948561350f, 0.949045882f,
+    0.949528181f, 0.950008245f, 0.950486074f, 0.950961666f, 0.951435021f, 0.951906137f,
+    0.952375013f, 0.952841648f, 0.953306040f, 0.953768190f, 0.954228095f, 0.954685755f,
+    0.955141168f, 0.955594334f, 0.956045251f, 0.956493919f, 0.956940336f, 0.957384501f,
+    0.957826413f, 0.958266071f, 0.958703475f, 0.959138622f, 0.959571513f, 0.960002146f,
+    0.960430519f, 0.960856633f, 0.961280486f, 0.961702077f, 0.962121404f, 0.962538468f,
+    0.962953267f, 0.963365800f, 0.963776066f, 0.964184064f, 0.964589793f, 0.964993253f,
+    0.965394442f, 0.965793359f, 0.966190003f, 0.966584374f, 0.966976471f, 0.967366292f,
+    0.967753837f, 0.968139105f, 0.968522094f, 0.968902805f, 0.969281235f, 0.969657385f,
+    0.970031253f, 0.970402839f, 0.970772141f, 0.971139158f, 0.971503891f, 0.971866337f,
+    0.972226497f, 0.972584369f, 0.972939952f, 0.973293246f, 0.973644250f, 0.973992962f,
+    0.974339383f, 0.974683511f, 0.975025345f, 0.975364885f, 0.975702130f, 0.976037079f,
+    0.976369731f, 0.976700086f, 0.977028143f, 0.977353900f, 0.977677358f, 0.977998515f,
+    0.978317371f, 0.978633924f, 0.978948175f, 0.979260123f, 0.979569766f, 0.979877104f,
+    0.980182136f, 0.980484862f, 0.980785280f, 0.981083391f, 0.981379193f, 0.981672686f,
+    0.981963869f, 0.982252741f, 0.982539302f, 0.982823551f, 0.983105487f, 0.983385110f,
+    0.983662419f, 0.983937413f, 0.984210092f, 0.984480455f, 0.984748502f, 0.985014231f,
+    0.985277642f, 0.985538735f, 0.985797509f, 0.986053963f, 0.986308097f, 0.986559910f,
+    0.986809402f, 0.987056571f, 0.987301418f, 0.987543942f, 0.987784142f, 0.988022017f,
+    0.988257568f, 0.988490793f, 0.988721692f, 0.988950265f, 0.989176510f, 0.989400428f,
+    0.989622017f, 0.989841278f, 0.990058210f, 0.990272812f, 0.990485084f, 0.990695025f,
+    0.990902635f, 0.991107914f, 0.991310860f, 0.991511473f, 0.991709754f, 0.991905700f,
+    0.992099313f, 0.992290591f, 0.992479535f, 0.992666142f, 0.992850414f, 0.993032350f,
+    0.993211949f, 0.993389211f, 0.993564136f, 0.993736722f, 0.993906970f, 0.994074879f,
+    0.994240449f, 0.994403680f, 0.994564571f, 0.994723121f, 0.994879331f, 0.995033199f,
+    0.995184727f, 0.995333912f, 0.995480755f, 0.995625256f, 0.995767414f, 0.995907229f,
+    0.996044701f, 0.996179829f, 0.996312612f, 0.996443051f, 0.996571146f, 0.996696895f,
+    0.996820299f, 0.996941358f, 0.997060070f, 0.997176437f, 0.997290457f, 0.997402130f,
+    0.997511456f, 0.997618435f, 0.997723067f, 0.997825350f, 0.997925286f, 0.998022874f,
+    0.998118113f, 0.998211003f, 0.998301545f, 0.998389737f, 0.998475581f, 0.998559074f,
+    0.998640218f, 0.998719012f, 0.998795456f, 0.998869550f, 0.998941293f, 0.999010686f,
+    0.999077728f, 0.999142419f, 0.999204759f, 0.999264747f, 0.999322385f, 0.999377670f,
+    0.999430605f, 0.999481187f, 0.999529418f, 0.999575296f, 0.999618822f, 0.999659997f,
+    0.999698819f, 0.999735288f, 0.999769405f, 0.999801170f, 0.999830582f, 0.999857641f,
+    0.999882347f, 0.999904701f, 0.999924702f, 0.999942350f, 0.999957645f, 0.999970586f,
+    0.999981175f, 0.999989411f, 0.999995294f, 0.999998823f, 1.000000000f,
+};
+#else
+#error "no sine table of this size, add it with tools/trig/trig_table.py --bits"
+#endif
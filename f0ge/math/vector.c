@@ -2,6 +2,7 @@
 #include <math.h>
 #include "../utils/helpers.h"
 #include "../math/equation.h"
+#include "trig.h"
 
 
 Vector vector_copy(Vector *const other) {
@@ -70,9 +71,8 @@ float vector_dot(Vector *const a, Vector *const b) {
 void vector_rotate(Vector *const v, float deg, Vector *target) {
     float tx = v->x;
     float ty = v->y;
-    float rad = deg * DEG_2_RAD;
-    float cosrad = cosf(rad);
-    float sinrad = sinf(rad);
+    float cosrad, sinrad;
+    trig_sincos_degrees(deg, &sinrad, &cosrad);
     target->x = (float) (cosrad * tx - sinrad * ty);
     target->y = (float) (sinrad * tx + cosrad * ty);
 }
@@ -1,31 +1,74 @@
 #pragma once
 #include <furi.h>
 #include "math/matrix.h"
-#include "utils/list.h"
+#include "math/bounds.h"
+#include "utils/vec.h"
 #include "graphics/buffer.h"
 typedef struct RenderData RenderData;
 typedef struct RenderingData RenderingData;
+typedef struct LayerCache LayerCache;
+typedef struct NodePool NodePool;
 typedef struct Node Node;
 
 #define MAKE_NODE() (Node){ \
     .active=false, \
+    .sleeping=false, \
+    .is_static=false, \
+    .scroll_layer=false, \
     .transform=MAKE_TRANSFORM(), \
     .parent=NULL, \
-    .children=NULL, \
-    .components=NULL, \
+    .children=EMPTY_VEC, \
+    .components=EMPTY_VEC, \
     .sprite=NULL, \
-    .render_callback=NULL \
+    .render_callback=NULL, \
+    .draw_bounds=NULL \
 }
 
 struct Node {
     bool active;
+    bool sleeping; //excluded (with its subtree) from the update set, see node_sleep/node_wake
+    bool is_static; //the subtree is rendered once into an offscreen buffer and composited from there
+    bool scroll_layer; //background layer, the last frame is kept and shifted when the camera moves by whole pixels
     Transform transform;
     Node *parent;
-    List *children;
-    List *components;
+    Vec children;   //Node*
+    Vec components; //Component*
     RenderData *sprite;
+    Bounds bounds; //world space AABB of the node and all of its descendants, refreshed by the engine
+    bool _flips; //the subtree draws in COLOR_FLIP, layer caches cannot hold it. refreshed with the bounds
+    bool _bounds_dirty; //a descendant changed, the bounds are merged again once before the next render
 
     RenderingData *_rendering_data; //reference to engine cache
+    NodePool *_pool; //owner of pooled nodes, they are recycled instead of released
+    void *_block; //prefab instance or loaded scene the node lives in, the block is released with its root (the first node)
+    LayerCache *_static_cache;
+    LayerCache *_scroll_cache;
+
+    //intrusive links of the engine's active update set
+    bool _updating;
+    Node *_update_prev;
+    Node *_update_next;
+    //update-LOD state for nodes far outside the view
+    uint8_t _lod_skipped;
+    float _lod_delta;
 
     void (*render_callback)(Node *self, Buffer *buffer);
+    //world space area render_callback draws into, NULL if it can draw anywhere (never culled or cached).
+    //call node_bounds_changed after changing it. The callback has to stay inside set_clip (get_clip_rect) since
+    //scroll layers redraw strips of it, and renderers that draw in COLOR_FLIP have to leave it NULL
+    Bounds *draw_bounds;
+};
+
+// engine cache of a node, world space corners of its sprite
+struct RenderingData {
+    Node *node;
+    Vector cachedCorners[4];
+    Vector *cachedVertices; //world space vertices of a mesh sprite, owned by the engine
+    uint8_t cachedVertexCount;
 };
+
+#define EMPTY_RENDERING_DATA (RenderingData){ \
+    .node=NULL, \
+    .cachedVertices=NULL, \
+    .cachedVertexCount=0 \
+}
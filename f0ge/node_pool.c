@@ -0,0 +1,94 @@
+#include "node_pool.h"
+#include "f0ge.h"
+#include "utils/helpers.h"
+
+static void reset_slot(NodePool *pool, uint16_t index) {
+    Node *node = &(pool->nodes[index]);
+    *node = MAKE_NODE();
+    node->_pool = pool;
+    node->_rendering_data = &(pool->rendering_data[index]);
+}
+
+NodePool *node_pool_create(uint16_t capacity) {
+    NodePool *pool = allocate(sizeof(NodePool));
+    check_pointer(pool);
+    pool->capacity = capacity;
+    pool->nodes = allocate(sizeof(Node) * capacity);
+    pool->rendering_data = allocate(sizeof(RenderingData) * capacity);
+    pool->generations = allocate(sizeof(uint16_t) * capacity);
+    pool->free_slots = allocate(sizeof(uint16_t) * capacity);
+    check_pointer(pool->nodes);
+    check_pointer(pool->rendering_data);
+    check_pointer(pool->generations);
+    check_pointer(pool->free_slots);
+
+    // the lowest slots are handed out first
+    pool->free_count = capacity;
+    for (uint16_t i = 0; i < capacity; i++) {
+        pool->rendering_data[i] = EMPTY_RENDERING_DATA;
+        reset_slot(pool, i);
+        pool->generations[i] = 0;
+        pool->free_slots[i] = capacity - 1 - i;
+    }
+    return pool;
+}
+
+void node_pool_release(NodePool *pool) {
+    if (!pool) return;
+    node_pool_despawn_all(pool);
+    release(pool->nodes);
+    release(pool->rendering_data);
+    release(pool->generations);
+    release(pool->free_slots);
+    release(pool);
+}
+
+Node *node_pool_spawn(NodePool *pool, NodeHandle *handle) {
+    if (pool->free_count == 0) {
+        if (handle) *handle = NODE_HANDLE_NONE;
+        return NULL;
+    }
+    const uint16_t index = pool->free_slots[--pool->free_count];
+    pool->generations[index]++;
+    if (handle) *handle = (NodeHandle) {.index = index, .generation = pool->generations[index]};
+    return &(pool->nodes[index]);
+}
+
+Node *node_pool_get(NodePool *pool, NodeHandle handle) {
+    if (handle.index >= pool->capacity || pool->generations[handle.index] != handle.generation) return NULL;
+    return &(pool->nodes[handle.index]);
+}
+
+NodeHandle node_pool_handle(NodePool *pool, Node *node) {
+    if (node->_pool != pool) return NODE_HANDLE_NONE;
+    const uint16_t index = node - pool->nodes;
+    if (!(pool->generations[index] & 1)) return NODE_HANDLE_NONE;
+    return (NodeHandle) {.index = index, .generation = pool->generations[index]};
+}
+
+bool node_pool_despawn(NodePool *pool, NodeHandle handle) {
+    Node *node = node_pool_get(pool, handle);
+    if (!node) return false;
+    node_destroy(node);
+    return true;
+}
+
+void node_pool_despawn_all(NodePool *pool) {
+    for (uint16_t i = 0; i < pool->capacity; i++) {
+        //children of pooled nodes are recycled together with their parent
+        if (pool->generations[i] & 1) node_destroy(&(pool->nodes[i]));
+    }
+}
+
+uint16_t node_pool_alive(NodePool *pool) {
+    return pool->capacity - pool->free_count;
+}
+
+void node_pool_recycle(Node *node) {
+    NodePool *pool = node->_pool;
+    const uint16_t index = node - pool->nodes;
+    if (!(pool->generations[index] & 1)) return;
+    pool->generations[index]++;
+    reset_slot(pool, index);
+    pool->free_slots[pool->free_count++] = index;
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <furi.h>
+#include "node.h"
+
+// Fixed capacity store of nodes for short lived objects (projectiles, pickups, particles...).
+// Spawning and despawning never touch the heap, the rendering caches are recycled with the nodes.
+// Handles are generation checked, a handle of a despawned node resolves to NULL even after its slot is reused.
+
+typedef struct {
+    uint16_t index;
+    uint16_t generation;
+} NodeHandle;
+
+#define NODE_HANDLE_NONE (NodeHandle){ \
+    .index=UINT16_MAX, \
+    .generation=0 \
+}
+
+struct NodePool {
+    Node *nodes;
+    RenderingData *rendering_data;
+    uint16_t *generations;  //odd while the slot is alive
+    uint16_t *free_slots;
+    uint16_t free_count;
+    uint16_t capacity;
+};
+
+NodePool *node_pool_create(uint16_t capacity);
+
+// despawns the nodes that are still alive, release the pool after cleanup_engine or node_pool_despawn_all
+void node_pool_release(NodePool *pool);
+
+// takes a free node initialized like MAKE_NODE, add it to the scene with add_child
+// returns NULL if the pool is exhausted, handle is optional
+Node *node_pool_spawn(NodePool *pool, NodeHandle *handle);
+
+// NULL if the node was despawned since
+Node *node_pool_get(NodePool *pool, NodeHandle handle);
+
+NodeHandle node_pool_handle(NodePool *pool, Node *node);
+
+// removes the node and its subtree from the scene and recycles them, safe from the node's own update
+bool node_pool_despawn(NodePool *pool, NodeHandle handle);
+
+// despawns every living node of the pool, eg. at a scene change
+void node_pool_despawn_all(NodePool *pool);
+
+uint16_t node_pool_alive(NodePool *pool);
+
+// engine side, called by node_free for pooled nodes
+void node_pool_recycle(Node *node);
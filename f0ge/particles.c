@@ -0,0 +1,240 @@
+#include "particles.h"
+#include "f0ge.h"
+#include "graphics/render.h"
+#include "math/equation.h"
+#include "utils/helpers.h"
+
+// xorshift32, a float in -1..1
+static float random_unit(ParticleEmitter *emitter) {
+    uint32_t x = emitter->random;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    emitter->random = x;
+    return (float) (x >> 8) / (float) (1 << 23) - 1.0f;
+}
+
+// pixels covered around a particle position
+static float particle_extent(const ParticleConfig *config, bool vertical) {
+    switch (config->shape) {
+        case ParticleRect:
+            return config->size / 2.0f + 1;
+        case ParticleSprite:
+            if (!config->sprite) return 0;
+            return (vertical ? config->sprite->height : config->sprite->real_width) / 2.0f + 1;
+        default:
+            return 1;
+    }
+}
+
+// the live particles moved, min and max are their positions
+static void set_area(ParticleEmitter *emitter, float min_x, float min_y, float max_x, float max_y) {
+    const ParticleConfig *config = &(emitter->config);
+    const bool was_empty = bounds_is_empty(&(emitter->area));
+    if (emitter->count == 0) {
+        emitter->area = BOUNDS_EMPTY;
+        if (was_empty) return;
+    } else {
+        const float ex = particle_extent(config, false), ey = particle_extent(config, true);
+        emitter->area = (Bounds) {.min={min_x - ex, min_y - ey}, .max={max_x + ex, max_y + ey}};
+    }
+    if (emitter->node.draw_bounds) node_bounds_changed(&(emitter->node));
+}
+
+static void emit(ParticleEmitter *emitter, uint16_t count) {
+    count = MIN(count, emitter->config.capacity - emitter->count);
+    if (count == 0) return;
+
+    const ParticleConfig *config = &(emitter->config);
+    Matrix *world = &(emitter->node.transform.transformation_matrix);
+    Vector origin;
+    matrix_get_translation(world, &origin);
+    float s, c;
+    matrix_get_sincos(world, &s, &c);
+
+    for (uint16_t n = 0; n < count; n++) {
+        const uint16_t i = emitter->count++;
+        emitter->x[i] = origin.x + config->spread.x * random_unit(emitter);
+        emitter->y[i] = origin.y + config->spread.y * random_unit(emitter);
+        const float vx = config->velocity.x + config->velocity_jitter.x * random_unit(emitter);
+        const float vy = config->velocity.y + config->velocity_jitter.y * random_unit(emitter);
+        emitter->vx[i] = c * vx - s * vy;
+        emitter->vy[i] = s * vx + c * vy;
+        emitter->life[i] = config->lifetime + config->lifetime_jitter * random_unit(emitter);
+    }
+}
+
+static void particles_update(Node *self, float delta, void *data) {
+    UNUSED(self);
+    ParticleEmitter *emitter = data;
+    const ParticleConfig *config = &(emitter->config);
+
+    if (emitter->emitting && config->rate > 0) {
+        emitter->pending += config->rate * delta;
+        const uint16_t count = (uint16_t) emitter->pending;
+        emitter->pending -= count;
+        emit(emitter, count);
+    }
+
+    const float gx = config->gravity.x * delta;
+    const float gy = config->gravity.y * delta;
+    const float drag = MAX(0.0f, 1.0f - config->drag * delta);
+    float *x = emitter->x, *y = emitter->y, *vx = emitter->vx, *vy = emitter->vy, *life = emitter->life;
+    uint16_t count = emitter->count;
+    float min_x = FLT_MAX, min_y = FLT_MAX, max_x = -FLT_MAX, max_y = -FLT_MAX;
+    for (uint16_t i = 0; i < count;) {
+        life[i] -= delta;
+        if (life[i] <= 0) {
+            //the last particle takes the place of the dead one, it is updated in the next round
+            count--;
+            x[i] = x[count];
+            y[i] = y[count];
+            vx[i] = vx[count];
+            vy[i] = vy[count];
+            life[i] = life[count];
+            continue;
+        }
+        vx[i] = (vx[i] + gx) * drag;
+        vy[i] = (vy[i] + gy) * drag;
+        x[i] += vx[i] * delta;
+        y[i] += vy[i] * delta;
+        min_x = MIN(min_x, x[i]);
+        min_y = MIN(min_y, y[i]);
+        max_x = MAX(max_x, x[i]);
+        max_y = MAX(max_y, y[i]);
+        i++;
+    }
+    emitter->count = count;
+    set_area(emitter, min_x, min_y, max_x, max_y);
+}
+
+// a sprite crossing the clip edge, copied pixel by pixel like buffer_blit
+static void blit_clipped(Buffer *buffer, const ParticleConfig *config, int16_t x, int16_t y,
+                         int16_t x0, int16_t y0, int16_t x1, int16_t y1) {
+    Buffer *sprite = config->sprite;
+    Buffer *mask = config->mask ? config->mask : sprite;
+    const int16_t left = MAX(x0, x), right = MIN(x1, x + sprite->width - 1);
+    const int16_t top = MAX(y0, y), bottom = MIN(y1, y + sprite->height - 1);
+    for (int16_t py = top; py <= bottom; py++) {
+        for (int16_t px = left; px <= right; px++) {
+            if (!buffer_read_pixel(mask, px - x, py - y)) continue;
+            buffer_set_pixel(buffer, px, py, buffer_read_pixel(sprite, px - x, py - y) ? COLOR_BLACK : COLOR_WHITE);
+        }
+    }
+}
+
+static void particles_render(Node *self, Buffer *buffer) {
+    ParticleEmitter *emitter = (ParticleEmitter *) self;
+    const ParticleConfig *config = &(emitter->config);
+    const Vector camera = get_camera();
+    const float *x = emitter->x, *y = emitter->y;
+    const uint16_t count = emitter->count;
+    //scroll layers redraw strips of the emitter, nothing may be written outside set_clip
+    int16_t x0, y0, x1, y1;
+    if (!get_clip_rect(buffer, &x0, &y0, &x1, &y1)) return;
+
+    switch (config->shape) {
+        case ParticlePixel: {
+            const uint16_t stride = (buffer->width + 7) / 8;
+            for (uint16_t i = 0; i < count; i++) {
+                const int16_t px = FLOOR(x[i] - camera.x);
+                const int16_t py = FLOOR(y[i] - camera.y);
+                if (px < x0 || px > x1 || py < y0 || py > y1) continue;
+                buffer_apply_bits(&(buffer->data[py * stride + (px >> 3)]), 1 << (px & 7), config->color);
+            }
+            break;
+        }
+        case ParticleRect: {
+            const float half = config->size / 2.0f;
+            for (uint16_t i = 0; i < count; i++) {
+                const int16_t px = FLOOR(x[i] - camera.x - half);
+                const int16_t py = FLOOR(y[i] - camera.y - half);
+                const int16_t left = MAX(x0, px), right = MIN(x1, px + config->size - 1);
+                const int16_t top = MAX(y0, py), bottom = MIN(y1, py + config->size - 1);
+                if (left > right || top > bottom) continue;
+                buffer_fill_rect(buffer, left, top, right - left + 1, bottom - top + 1, config->color);
+            }
+            break;
+        }
+        case ParticleSprite: {
+            if (!config->sprite) break;
+            const float half_width = config->sprite->real_width / 2.0f;
+            const float half_height = config->sprite->height / 2.0f;
+            const int16_t width = config->sprite->width, height = config->sprite->height;
+            //buffer_blit only clips to the buffer
+            const bool unclipped = x0 == 0 && y0 == 0 && x1 == buffer->width - 1 && y1 == buffer->height - 1;
+            for (uint16_t i = 0; i < count; i++) {
+                const int16_t px = FLOOR(x[i] - camera.x - half_width);
+                const int16_t py = FLOOR(y[i] - camera.y - half_height);
+                if (unclipped || (px >= x0 && px + width - 1 <= x1 && py >= y0 && py + height - 1 <= y1)) {
+                    buffer_blit(buffer, config->sprite, config->mask, px, py);
+                } else {
+                    blit_clipped(buffer, config, px, py, x0, y0, x1, y1);
+                }
+            }
+            break;
+        }
+    }
+}
+
+ParticleEmitter *particle_emitter_create(ParticleConfig config) {
+    //the emitter, its node and the pool share one block, released by node_free with the node
+    const size_t header = ALIGN8(sizeof(ParticleEmitter));
+    const size_t array = ALIGN8(sizeof(float) * config.capacity);
+    uint8_t *block = allocate(header + array * 5);
+    check_pointer(block);
+
+    ParticleEmitter *emitter = (ParticleEmitter *) block;
+    emitter->node = MAKE_NODE();
+    emitter->node._block = emitter;
+    emitter->rendering_data = EMPTY_RENDERING_DATA;
+    emitter->node._rendering_data = &(emitter->rendering_data);
+    emitter->node.render_callback = &particles_render;
+    emitter->rendering_data.node = &(emitter->node);
+
+    emitter->config = config;
+    emitter->emitting = config.rate > 0;
+    emitter->pending = 0;
+    emitter->random = config.seed ? config.seed : 1;
+    emitter->count = 0;
+    emitter->x = (float *) (block + header);
+    emitter->y = (float *) (block + header + array);
+    emitter->vx = (float *) (block + header + array * 2);
+    emitter->vy = (float *) (block + header + array * 3);
+    emitter->life = (float *) (block + header + array * 4);
+    emitter->area = BOUNDS_EMPTY;
+    //flipped pixels cannot be cached, such emitters keep infinite bounds
+    emitter->node.draw_bounds = config.color == COLOR_FLIP ? NULL : &(emitter->area);
+
+    emitter->component = MAKE_COMPONENT();
+    emitter->component.update = &particles_update;
+    emitter->component.data = emitter;
+    add_component(&(emitter->node), &(emitter->component));
+    return emitter;
+}
+
+void particle_emitter_burst(ParticleEmitter *emitter, uint16_t count) {
+    const uint16_t first = emitter->count;
+    emit(emitter, count);
+    if (emitter->count == first) return;
+
+    //the area is refreshed right away, the emitter might not be updated again before the next render
+    float min_x = FLT_MAX, min_y = FLT_MAX, max_x = -FLT_MAX, max_y = -FLT_MAX;
+    for (uint16_t i = 0; i < emitter->count; i++) {
+        min_x = MIN(min_x, emitter->x[i]);
+        min_y = MIN(min_y, emitter->y[i]);
+        max_x = MAX(max_x, emitter->x[i]);
+        max_y = MAX(max_y, emitter->y[i]);
+    }
+    set_area(emitter, min_x, min_y, max_x, max_y);
+}
+
+void particle_emitter_set_emitting(ParticleEmitter *emitter, bool emitting) {
+    emitter->emitting = emitting;
+    emitter->pending = 0;
+}
+
+void particle_emitter_clear(ParticleEmitter *emitter) {
+    emitter->count = 0;
+    set_area(emitter, 0, 0, 0, 0);
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include <furi.h>
+#include "node.h"
+#include "component.h"
+#include "math/vector.h"
+#include "graphics/buffer.h"
+
+// Particle effects (smoke, sparks, debris) without a node per particle.
+// An emitter is a single node, its particles live in a fixed pool stored as separate arrays (structure of arrays),
+// are moved in one loop per frame and drawn straight into the screen buffer as pixels, small rects or sprites.
+// Particles are in world space once emitted, so they stay behind a moving emitter.
+// The area of the live particles is tracked while they move and culls the emitter like a sprite. Emitters drawing
+// in COLOR_FLIP report no area, they are always drawn and never baked into static or scroll layers.
+
+typedef enum {
+    ParticlePixel,
+    ParticleRect,   // size x size square centered on the particle
+    ParticleSprite, // sprite (and mask) centered on the particle
+} ParticleShape;
+
+typedef struct {
+    uint16_t capacity;      // the oldest particles are not replaced, new ones are dropped while the pool is full
+    float rate;             // particles per second while emitting, 0 for bursts only
+    float lifetime;         // seconds
+    float lifetime_jitter;  // +- seconds
+    Vector spread;          // +- world units around the emitter per axis
+    Vector velocity;        // world units per second, in the space of the emitter node (follows its rotation)
+    Vector velocity_jitter; // +- per axis
+    Vector gravity;         // world units per second^2
+    float drag;             // part of the velocity lost per second, 0-1
+    ParticleShape shape;
+    uint8_t size;
+    Buffer *sprite;         // not owned
+    Buffer *mask;
+    PixelColor color;
+    uint32_t seed;          // particles are deterministic per seed, so replays and goldens match
+} ParticleConfig;
+
+#define MAKE_PARTICLE_CONFIG(count, life) (ParticleConfig){ \
+    .capacity=count, \
+    .rate=0, \
+    .lifetime=life, \
+    .lifetime_jitter=0, \
+    .spread={0, 0}, \
+    .velocity={0, 0}, \
+    .velocity_jitter={0, 0}, \
+    .gravity={0, 0}, \
+    .drag=0, \
+    .shape=ParticlePixel, \
+    .size=1, \
+    .sprite=NULL, \
+    .mask=NULL, \
+    .color=COLOR_BLACK, \
+    .seed=1 \
+}
+
+typedef struct {
+    Node node;              // first member, add it to the scene with add_child(parent, &emitter->node)
+    RenderingData rendering_data;
+    Component component;
+    ParticleConfig config;
+    bool emitting;
+    float pending;          // fraction of a particle carried to the next frame
+    uint32_t random;
+    uint16_t count;         // live particles are packed at the start of the arrays
+    float *x;
+    float *y;
+    float *vx;
+    float *vy;
+    float *life;            // seconds left
+    Bounds area;            // world space area of the live particles, the bounds of the node
+} ParticleEmitter;
+
+// one allocation with the pool, it is released with the node (node_free, node_destroy or cleanup_engine)
+ParticleEmitter *particle_emitter_create(ParticleConfig config);
+
+// emits count particles at once, eg. an explosion
+void particle_emitter_burst(ParticleEmitter *emitter, uint16_t count);
+
+// continuous emission at config.rate, on by default when the rate is not 0
+void particle_emitter_set_emitting(ParticleEmitter *emitter, bool emitting);
+
+// removes every live particle
+void particle_emitter_clear(ParticleEmitter *emitter);
@@ -0,0 +1,86 @@
+#include "prefab.h"
+#include "f0ge.h"
+#include "utils/helpers.h"
+
+// block layout: nodes | rendering data | components | component data (8 byte aligned each)
+
+static size_t components_offset(const Prefab *prefab) {
+    return ALIGN8(sizeof(Node) * prefab->node_count) + ALIGN8(sizeof(RenderingData) * prefab->node_count);
+}
+
+static size_t data_offset(const Prefab *prefab) {
+    return components_offset(prefab) + ALIGN8(sizeof(Component) * prefab->component_count);
+}
+
+size_t prefab_size(const Prefab *prefab) {
+    size_t size = data_offset(prefab);
+    for (uint16_t i = 0; i < prefab->component_count; i++) {
+        if (prefab->components[i].data) size += ALIGN8(prefab->components[i].data_size);
+    }
+    return size;
+}
+
+static bool prefab_valid(const Prefab *prefab) {
+    if (prefab->node_count == 0 || prefab->nodes[0].parent != PREFAB_ROOT) return false;
+    for (uint16_t i = 1; i < prefab->node_count; i++) {
+        if (prefab->nodes[i].parent < 0 || prefab->nodes[i].parent >= i) return false;
+    }
+    for (uint16_t i = 0; i < prefab->component_count; i++) {
+        if (prefab->components[i].node >= prefab->node_count) return false;
+    }
+    return true;
+}
+
+Node *prefab_instantiate(const Prefab *prefab, Node *parent, Vector offset) {
+    if (!prefab_valid(prefab)) {
+        FURI_LOG_E("PREFAB", "Parents have to come before their children");
+        return NULL;
+    }
+
+    uint8_t *block = allocate(prefab_size(prefab));
+    check_pointer(block);
+    Node *nodes = (Node *) block;
+    RenderingData *rendering_data = (RenderingData *) (block + ALIGN8(sizeof(Node) * prefab->node_count));
+    Component *components = (Component *) (block + components_offset(prefab));
+    uint8_t *data = block + data_offset(prefab);
+
+    for (uint16_t i = 0; i < prefab->node_count; i++) {
+        const PrefabNode *record = &(prefab->nodes[i]);
+        Node *node = &(nodes[i]);
+        *node = MAKE_NODE();
+        node->transform.position = record->position;
+        node->transform.scale = record->scale;
+        node->transform.rotation = record->rotation;
+        node->sprite = record->sprite;
+        rendering_data[i] = EMPTY_RENDERING_DATA;
+        node->_rendering_data = &(rendering_data[i]);
+        node->_block = block;
+        if (record->parent != PREFAB_ROOT) {
+            Node *p = &(nodes[record->parent]);
+            node->parent = p;
+            vec_push(&(p->children), node);
+        }
+    }
+    vector_add(&(nodes[0].transform.position), &offset, &(nodes[0].transform.position));
+
+    for (uint16_t i = 0; i < prefab->component_count; i++) {
+        const PrefabComponent *record = &(prefab->components[i]);
+        Component *component = &(components[i]);
+        *component = *(record->component);
+        if (record->data) {
+            memcpy(data, record->data, record->data_size);
+            component->data = data;
+            data += ALIGN8(record->data_size);
+        }
+        vec_push(&(nodes[record->node].components), component);
+    }
+
+    if (parent) add_child(parent, &(nodes[0]));
+    return &(nodes[0]);
+}
+
+void *prefab_component_data(Node *root, const Prefab *prefab, uint16_t component) {
+    if (!root->_block || component >= prefab->component_count) return NULL;
+    Component *components = (Component *) ((uint8_t *) root->_block + components_offset(prefab));
+    return components[component].data;
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <furi.h>
+#include "node.h"
+#include "component.h"
+#include "graphics/render.h"
+
+// A prefab describes a node subtree as flat records, instancing it is one allocation and one pass.
+// Sprites and component callbacks are shared, component data is copied per instance.
+
+#define PREFAB_ROOT -1
+
+typedef struct {
+    int16_t parent;     // index of an earlier record, PREFAB_ROOT for the first one
+    Vector position;
+    Vector scale;
+    float rotation;
+    RenderData *sprite;
+} PrefabNode;
+
+#define PREFAB_NODE(parent_index, x, y, render_data) (PrefabNode){ \
+    .parent=parent_index, \
+    .position={x, y}, \
+    .scale={1, 1}, \
+    .rotation=0, \
+    .sprite=render_data \
+}
+
+typedef struct {
+    uint16_t node;              // record the component is added to
+    const Component *component;
+    const void *data;           // initial state copied into every instance, NULL shares component->data
+    uint16_t data_size;
+} PrefabComponent;
+
+typedef struct {
+    const PrefabNode *nodes;
+    uint16_t node_count;
+    const PrefabComponent *components;
+    uint16_t component_count;
+} Prefab;
+
+// size of the block an instance lives in
+size_t prefab_size(const Prefab *prefab);
+
+// builds the subtree, the root is moved by offset and added to parent when given
+// the nodes are released together with the root, do not move nodes of an instance to another tree
+Node *prefab_instantiate(const Prefab *prefab, Node *parent, Vector offset);
+
+// data of the n-th component record of the prefab in this instance
+void *prefab_component_data(Node *root, const Prefab *prefab, uint16_t component);
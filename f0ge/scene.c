@@ -0,0 +1,276 @@
+#include "scene.h"
+#include "f0ge.h"
+#include "graphics/asset.h"
+#include "utils/helpers.h"
+#include <storage/storage.h>
+
+#define SCENE_READ_BUFFER 128
+#define SCENE_HEADER_SIZE 20
+#define SCENE_SPRITE_SIZE 72
+#define SCENE_NODE_SIZE 25
+
+static const uint8_t scene_magic[4] = {'F', '0', 'S', 'C'};
+
+typedef struct {
+    File *file;
+    uint8_t buffer[SCENE_READ_BUFFER];
+    uint16_t pos;
+    uint16_t len;
+} SceneReader;
+
+typedef struct {
+    uint16_t node_count;
+    uint16_t sprite_count;
+    uint16_t component_count;
+    uint16_t asset_count;
+    uint16_t type_count;
+    uint32_t data_size;
+} SceneHeader;
+
+static bool read_bytes(SceneReader *reader, void *data, size_t size) {
+    uint8_t *out = data;
+    while (size > 0) {
+        if (reader->pos == reader->len) {
+            reader->len = storage_file_read(reader->file, reader->buffer, SCENE_READ_BUFFER);
+            reader->pos = 0;
+            if (reader->len == 0) return false;
+        }
+        size_t chunk = reader->len - reader->pos;
+        if (chunk > size) chunk = size;
+        memcpy(out, reader->buffer + reader->pos, chunk);
+        reader->pos += chunk;
+        out += chunk;
+        size -= chunk;
+    }
+    return true;
+}
+
+static inline uint16_t get_u16(const uint8_t *data) {
+    return data[0] | (data[1] << 8);
+}
+
+static inline uint32_t get_u32(const uint8_t *data) {
+    return data[0] | (data[1] << 8) | (data[2] << 16) | ((uint32_t) data[3] << 24);
+}
+
+static inline float get_f32(const uint8_t *data) {
+    uint32_t bits = get_u32(data);
+    float value;
+    memcpy(&value, &bits, sizeof(float));
+    return value;
+}
+
+static inline Vector get_vector(const uint8_t *data) {
+    return (Vector){get_f32(data), get_f32(data + 4)};
+}
+
+static bool read_name(SceneReader *reader, char name[SCENE_NAME_LENGTH]) {
+    uint8_t length;
+    if (!read_bytes(reader, &length, 1) || length >= SCENE_NAME_LENGTH) return false;
+    if (!read_bytes(reader, name, length)) return false;
+    name[length] = 0;
+    return true;
+}
+
+// block layout: nodes | rendering data | sprites | components | component data (8 byte aligned each)
+static size_t block_size(const SceneHeader *header, size_t *offsets) {
+    offsets[0] = 0;
+    offsets[1] = offsets[0] + ALIGN8(sizeof(Node) * header->node_count);
+    offsets[2] = offsets[1] + ALIGN8(sizeof(RenderingData) * header->node_count);
+    offsets[3] = offsets[2] + ALIGN8(sizeof(RenderData) * header->sprite_count);
+    offsets[4] = offsets[3] + ALIGN8(sizeof(Component) * header->component_count);
+    return offsets[4] + header->data_size;
+}
+
+// resolves the name tables of the file against the registry
+static bool read_names(SceneReader *reader, const SceneHeader *header, const SceneRegistry *registry,
+                       Buffer **assets, const SceneComponent **types) {
+    char name[SCENE_NAME_LENGTH];
+    for (uint16_t i = 0; i < header->asset_count; i++) {
+        if (!read_name(reader, name)) return false;
+        assets[i] = NULL;
+        for (uint16_t j = 0; j < registry->asset_count; j++) {
+            const SceneAsset *asset = &(registry->assets[j]);
+            if (strcmp(asset->name, name) != 0) continue;
+            assets[i] = asset->buffer ? asset->buffer : asset_get_icon(asset->icon);
+            break;
+        }
+        if (!assets[i]) {
+            FURI_LOG_E("SCENE", "Unknown asset %s", name);
+            return false;
+        }
+    }
+    for (uint16_t i = 0; i < header->type_count; i++) {
+        if (!read_name(reader, name)) return false;
+        types[i] = NULL;
+        for (uint16_t j = 0; j < registry->component_count; j++) {
+            if (strcmp(registry->components[j].name, name) != 0) continue;
+            types[i] = &(registry->components[j]);
+            break;
+        }
+        if (!types[i]) {
+            FURI_LOG_E("SCENE", "Unknown component %s", name);
+            return false;
+        }
+    }
+    return true;
+}
+
+static inline Buffer *asset_at(Buffer **assets, uint16_t count, uint16_t index, bool *valid) {
+    if (index == SCENE_NONE) return NULL;
+    if (index >= count) *valid = false;
+    return *valid ? assets[index] : NULL;
+}
+
+static bool read_sprites(SceneReader *reader, const SceneHeader *header, Buffer **assets, RenderData *sprites) {
+    uint8_t record[SCENE_SPRITE_SIZE];
+    for (uint16_t i = 0; i < header->sprite_count; i++) {
+        if (!read_bytes(reader, record, SCENE_SPRITE_SIZE)) return false;
+        bool valid = true;
+        RenderData *sprite = &(sprites[i]);
+        sprite->sprite = asset_at(assets, header->asset_count, get_u16(record), &valid);
+        sprite->mask = asset_at(assets, header->asset_count, get_u16(record + 2), &valid);
+        sprite->color = record[4];
+        sprite->mask_color = record[5];
+        sprite->tile_mode = record[6];
+        sprite->callback = NULL;
+        sprite->mesh = NULL;
+        for (uint8_t c = 0; c < 4; c++) {
+            sprite->poly.corners[c] = get_vector(record + 8 + c * 8);
+            sprite->poly.uv[c] = get_vector(record + 40 + c * 8);
+        }
+        flip_uv(&(sprite->poly), record[7]);
+        if (!valid) return false;
+    }
+    return true;
+}
+
+static bool read_nodes(SceneReader *reader, const SceneHeader *header, Node *nodes, RenderingData *rendering_data,
+                       RenderData *sprites, void *block) {
+    uint8_t record[SCENE_NODE_SIZE];
+    for (uint16_t i = 0; i < header->node_count; i++) {
+        if (!read_bytes(reader, record, SCENE_NODE_SIZE)) return false;
+        int16_t parent = (int16_t) get_u16(record);
+        uint16_t sprite = get_u16(record + 2);
+        uint8_t flags = record[4];
+        if (i == 0 ? parent != -1 : (parent < 0 || parent >= i)) return false;
+        if (sprite != SCENE_NONE && sprite >= header->sprite_count) return false;
+
+        Node *node = &(nodes[i]);
+        node->is_static = flags & SCENE_NODE_STATIC;
+        node->scroll_layer = flags & SCENE_NODE_SCROLL_LAYER;
+        node->sleeping = flags & SCENE_NODE_SLEEPING;
+        node->transform.position = get_vector(record + 5);
+        node->transform.scale = get_vector(record + 13);
+        node->transform.rotation = get_f32(record + 21);
+        node->sprite = sprite == SCENE_NONE ? NULL : &(sprites[sprite]);
+        rendering_data[i] = EMPTY_RENDERING_DATA;
+        node->_rendering_data = &(rendering_data[i]);
+        node->_block = block;
+        if (i > 0) {
+            Node *p = &(nodes[parent]);
+            node->parent = p;
+            vec_push(&(p->children), node);
+        }
+    }
+    return true;
+}
+
+static bool read_components(SceneReader *reader, const SceneHeader *header, const SceneComponent **types,
+                            Node *nodes, Component *components, uint8_t *data) {
+    uint32_t data_used = 0;
+    for (uint16_t i = 0; i < header->component_count; i++) {
+        uint8_t record[6];
+        if (!read_bytes(reader, record, 6)) return false;
+        uint16_t node = get_u16(record);
+        uint16_t type = get_u16(record + 2);
+        uint16_t size = get_u16(record + 4);
+        if (node >= header->node_count || type >= header->type_count) return false;
+        if (size != types[type]->data_size) {
+            FURI_LOG_E("SCENE", "%s expects %u bytes, the file has %u", types[type]->name,
+                       types[type]->data_size, size);
+            return false;
+        }
+
+        Component *component = &(components[i]);
+        *component = *(types[type]->component);
+        if (size) {
+            if (data_used + ALIGN8(size) > header->data_size) return false;
+            if (!read_bytes(reader, data + data_used, size)) return false;
+            component->data = data + data_used;
+            data_used += ALIGN8(size);
+        }
+        vec_push(&(nodes[node].components), component);
+    }
+    return true;
+}
+
+// frees the vectors that may have spilled to the heap while the tree was built
+static void discard_nodes(Node *nodes, uint16_t count) {
+    for (uint16_t i = 0; i < count; i++) {
+        vec_clear(&(nodes[i].children));
+        vec_clear(&(nodes[i].components));
+    }
+}
+
+Node *scene_load(const char *path, const SceneRegistry *registry) {
+    SceneReader reader = {.pos = 0, .len = 0};
+    Storage *storage = furi_record_open(RECORD_STORAGE);
+    reader.file = storage_file_alloc(storage);
+    uint8_t *block = NULL;
+    void **lookup = NULL;
+    SceneHeader header = {0};
+    bool ok = false;
+
+    do {
+        if (!storage_file_open(reader.file, path, FSAM_READ, FSOM_OPEN_EXISTING)) {
+            FURI_LOG_E("SCENE", "Cannot open %s", path);
+            break;
+        }
+        uint8_t raw[SCENE_HEADER_SIZE];
+        if (!read_bytes(&reader, raw, SCENE_HEADER_SIZE) || memcmp(raw, scene_magic, 4) != 0 ||
+            raw[4] != SCENE_VERSION) {
+            FURI_LOG_E("SCENE", "%s is not a scene file", path);
+            break;
+        }
+        header.node_count = get_u16(raw + 6);
+        header.sprite_count = get_u16(raw + 8);
+        header.component_count = get_u16(raw + 10);
+        header.asset_count = get_u16(raw + 12);
+        header.type_count = get_u16(raw + 14);
+        header.data_size = get_u32(raw + 16);
+        if (header.node_count == 0) break;
+
+        //the resolved names are only needed while loading
+        lookup = allocate(sizeof(void *) * (header.asset_count + header.type_count + 1));
+        check_pointer(lookup);
+        Buffer **assets = (Buffer **) lookup;
+        const SceneComponent **types = (const SceneComponent **) (lookup + header.asset_count);
+        if (!read_names(&reader, &header, registry, assets, types)) break;
+
+        size_t offsets[5];
+        block = allocate(block_size(&header, offsets));
+        check_pointer(block);
+        Node *nodes = (Node *) (block + offsets[0]);
+        RenderData *sprites = (RenderData *) (block + offsets[2]);
+        for (uint16_t i = 0; i < header.node_count; i++) {
+            nodes[i] = MAKE_NODE();
+        }
+
+        if (!read_sprites(&reader, &header, assets, sprites)) break;
+        if (!read_nodes(&reader, &header, nodes, (RenderingData *) (block + offsets[1]), sprites, block)) break;
+        ok = read_components(&reader, &header, types, nodes, (Component *) (block + offsets[3]),
+                             block + offsets[4]);
+    } while (false);
+
+    if (!ok && block) {
+        FURI_LOG_E("SCENE", "%s is damaged", path);
+        discard_nodes((Node *) block, header.node_count);
+        release(block);
+    }
+    if (lookup) release(lookup);
+    storage_file_close(reader.file);
+    storage_file_free(reader.file);
+    furi_record_close(RECORD_STORAGE);
+    return ok ? (Node *) block : NULL;
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <furi.h>
+#include <gui/icon.h>
+#include "node.h"
+#include "component.h"
+#include "graphics/render.h"
+
+// Binary scene files, made from a text description with tools/scene/scene_convert.py.
+// The file is read once from the start to the end, the whole tree lands in one block like a prefab instance.
+// Layout (little endian):
+//   "F0SC", version u8, flags u8 (0)
+//   node_count u16, sprite_count u16, component_count u16, asset_count u16, type_count u16, data_size u32
+//   asset names, then component type names: length u8 + characters each
+//   sprites:    sprite u16, mask u16 (asset index, 0xFFFF = none), color u8, mask_color u8, tile u8, flip u8,
+//               corners f32[8], uv f32[8]
+//   nodes:      parent i16 (-1 for the first one), sprite u16 (0xFFFF = none), flags u8,
+//               position f32[2], scale f32[2], rotation f32
+//   components: node u16, type u16, data_size u16, data
+#define SCENE_VERSION 1
+#define SCENE_NONE 0xFFFF
+#define SCENE_NAME_LENGTH 32
+
+#define SCENE_NODE_STATIC (1 << 0)
+#define SCENE_NODE_SCROLL_LAYER (1 << 1)
+#define SCENE_NODE_SLEEPING (1 << 2)
+
+// the game maps the names used in the scene files to its assets and components
+typedef struct {
+    const char *name;
+    const Icon *icon;   // decoded through the asset cache
+    Buffer *buffer;     // used instead of the icon when set
+} SceneAsset;
+
+typedef struct {
+    const char *name;
+    const Component *component;
+    uint16_t data_size; // size of the parameters in the file, 0 shares component->data between the instances
+} SceneComponent;
+
+typedef struct {
+    const SceneAsset *assets;
+    uint16_t asset_count;
+    const SceneComponent *components;
+    uint16_t component_count;
+} SceneRegistry;
+
+// loads the tree of a scene file, NULL on error
+// the nodes are released together with the root (eg. by node_free or cleanup_engine)
+Node *scene_load(const char *path, const SceneRegistry *registry);
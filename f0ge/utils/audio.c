@@ -1,45 +1,29 @@
 #include "audio.h"
 #include "helpers.h"
+#include "../context.h"
+#include "../f0ge.h"
+#include <notification/notification_messages.h>
 
+// the sequencer checks the clock every tick, the sound calls only happen at note boundaries
+#define SEQUENCER_PERIOD 1
+#define COMMAND_TIMEOUT 50
 
-static MusicData *current_music = NULL;
-static bool looped = false;
-static bool stopped = true;
-static uint32_t last_start = 0;
-static uint32_t next_note = 0;
-
-static uint32_t current_note = 0;
-static float current_bpm = 0;
-static int current_separation = 0;
-static NotificationApp *notification_app;
-
-void setup_audio(NotificationApp *notificationApp) {
-    notification_app = notificationApp;
-}
-
-static const float reference_freq = 16.35f; //C0
-
-static NotificationMessage note = {
-    .data.sound.volume = 1,
-    .data.sound.frequency = reference_freq,
-    .type = NotificationMessageTypeSoundOn,
-};
-
-static NotificationMessage delay = {
-    .type=NotificationMessageTypeDelay,
-    .data.delay.length=250
+// 16.35 * 2 ^ (n / 12) Hz, from C0
+static const float note_frequencies[AUDIO_OCTAVES * 12] = {
+    16.35f, 17.32f, 18.35f, 19.44f, 20.60f, 21.82f, 23.12f, 24.50f, 25.95f, 27.50f, 29.13f, 30.86f,
+    32.70f, 34.64f, 36.70f, 38.89f, 41.20f, 43.65f, 46.24f, 48.99f, 51.91f, 54.99f, 58.26f, 61.73f,
+    65.40f, 69.29f, 73.41f, 77.77f, 82.40f, 87.30f, 92.49f, 97.99f, 103.82f, 109.99f, 116.53f, 123.46f,
+    130.80f, 138.58f, 146.82f, 155.55f, 164.80f, 174.60f, 184.98f, 195.98f, 207.63f, 219.98f, 233.06f, 246.92f,
+    261.60f, 277.16f, 293.64f, 311.10f, 329.60f, 349.19f, 369.96f, 391.96f, 415.26f, 439.96f, 466.12f, 493.84f,
+    523.20f, 554.31f, 587.27f, 622.19f, 659.19f, 698.39f, 739.92f, 783.91f, 830.53f, 879.91f, 932.24f, 987.67f,
+    1046.40f, 1108.62f, 1174.54f, 1244.39f, 1318.38f, 1396.78f, 1479.83f, 1567.83f, 1661.06f, 1759.83f, 1864.47f, 1975.34f,
+    2092.80f, 2217.24f, 2349.09f, 2488.77f, 2636.76f, 2793.55f, 2959.67f, 3135.66f, 3322.11f, 3519.66f, 3728.95f, 3950.68f,
+    4185.60f, 4434.49f, 4698.18f, 4977.55f, 5273.53f, 5587.11f, 5919.33f, 6271.31f, 6644.23f, 7039.31f, 7457.89f, 7901.36f,
 };
 
-static NotificationMessage off = {
-    .type = NotificationMessageTypeSoundOff,
-};
-
-static NotificationSequence music_sequence = {
-    &note,
-    &delay,
-    &off,
-    NULL
-};
+static inline AudioState *audio_state() {
+    return &(engine_context_current()->audio);
+}
 
 // Function to reverse scale the 16-bit integer to float note_length
 // return be between 0.0 and 4.0
@@ -55,71 +39,450 @@ Beat decode_note(uint32_t beat) {
     };
 }
 
-void set_volume(float volume) {
-    note.data.sound.volume = volume > 1.0f ? 1.0f : (volume < 0.0f ? 0.0f : volume);
-}
-
 float get_delay(uint8_t bpm) {
     return 60000.0f / bpm;
 }
 
 float get_frequency(Beat *b) {
-    float n = b->octave * 12.f + b->note;
-    return reference_freq * powf(2, (n / 12));
+    uint8_t octave = b->octave < AUDIO_OCTAVES ? b->octave : AUDIO_OCTAVES - 1;
+    return note_frequencies[octave * 12 + b->note];
 }
 
-void set_audio(MusicData *data) {
-    current_music = data;
-    current_bpm = get_delay(data->bpm);
-    current_separation = (int) floorf(current_bpm * current_music->separation);
+static inline uint8_t queue_count(AudioState *state) {
+    return (uint8_t) (state->queue_head - state->queue_tail);
 }
 
+// sequencer side, runs on the timer thread
 
-void update_audio() {
-    if (!notification_app || current_music == NULL || stopped ||
-        (looped == true && current_music->loop == false))
+static void voice_start(AudioVoice *voice, uint8_t priority, const SoundEffect *effect, uint32_t now) {
+    voice->active = true;
+    voice->sounding = false;
+    voice->priority = priority;
+    voice->effect = effect;
+    voice->position = 0;
+    voice->started = now;
+    voice->phase_end = now;
+}
+
+// false if the voice has to wait for the decoder
+static bool voice_next_event(AudioState *state, AudioVoice *voice, AudioEvent *event) {
+    if (voice->effect) {
+        if (voice->position == voice->effect->count) {
+            *event = (AudioEvent) {.pitch=AUDIO_PITCH_END};
+        } else {
+            *event = voice->effect->events[voice->position++];
+        }
+        return true;
+    }
+    if (queue_count(state) == 0) return false;
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    *event = state->queue[state->queue_tail & (AUDIO_LOOKAHEAD - 1)];
+    state->queue_tail++;
+    return true;
+}
+
+static void voice_advance(AudioState *state, AudioVoice *voice, uint32_t now) {
+    while (voice->active && (int32_t) (now - voice->phase_end) >= 0) {
+        if (voice->sounding) {
+            voice->sounding = false;
+            if (voice->current.gap) {
+                voice->phase_end += voice->current.gap;
+                continue;
+            }
+        }
+        AudioEvent event;
+        if (!voice_next_event(state, voice, &event)) {
+            //the decoder fell behind, continue from now instead of rushing the late notes
+            voice->phase_end = now;
+            return;
+        }
+        if (event.pitch == AUDIO_PITCH_END) {
+            voice->active = false;
+            if (!voice->effect) state->music_playing = false;
+            return;
+        }
+        if (event.pitch == AUDIO_PITCH_BUZZ) {
+            //the motor is a channel of its own, the voice stays silent meanwhile
+            if ((int32_t) (voice->phase_end + event.length - state->vibro_until) > 0) {
+                state->vibro_until = voice->phase_end + event.length;
+            }
+            event.pitch = AUDIO_PITCH_REST;
+        } else if (event.pitch >= AUDIO_OCTAVES * 12 && event.pitch != AUDIO_PITCH_REST) {
+            //hand built effects can go past the table, they play in the top octave
+            event.pitch = (AUDIO_OCTAVES - 1) * 12 + event.pitch % 12;
+        }
+        voice->current = event;
+        voice->sounding = true;
+        voice->phase_end += event.length;
+    }
+}
+
+static void take_requests(AudioState *state, uint32_t now) {
+    if (state->music_start) {
+        voice_start(&(state->music), AUDIO_MUSIC_PRIORITY, NULL, state->music_start_tick);
+        state->music_start = false;
+    }
+    if (state->vibro_request) {
+        if ((int32_t) (now + state->vibro_request - state->vibro_until) > 0) {
+            state->vibro_until = now + state->vibro_request;
+        }
+        state->vibro_request = 0;
+    }
+    while (state->sfx_tail != state->sfx_head) {
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        const SoundEffect *effect = &(state->effects[state->sfx_requests[state->sfx_tail & (AUDIO_SFX_REQUESTS - 1)]]);
+        state->sfx_tail++;
+
+        //a free voice, or the oldest of the lowest priority ones if that is not above the new effect
+        AudioVoice *target = NULL;
+        for (uint8_t i = 0; i < AUDIO_SFX_VOICES; i++) {
+            AudioVoice *voice = &(state->sfx[i]);
+            if (!voice->active) {
+                target = voice;
+                break;
+            }
+            if (!target || voice->priority < target->priority ||
+                (voice->priority == target->priority && (int32_t) (voice->started - target->started) < 0)) {
+                target = voice;
+            }
+        }
+        if (target->active && target->priority > effect->priority) continue;
+        voice_start(target, effect->priority, effect, now);
+    }
+}
+
+// the sounding tone of the highest priority, voices of the same priority take turns
+static float arbitrate(AudioState *state, uint32_t now) {
+    AudioVoice *candidates[AUDIO_SFX_VOICES + 1];
+    uint8_t count = 0;
+    int16_t best = -1;
+    for (uint8_t i = 0; i <= AUDIO_SFX_VOICES; i++) {
+        AudioVoice *voice = i == 0 ? &(state->music) : &(state->sfx[i - 1]);
+        //rests are past the table as well
+        if (!voice->active || !voice->sounding || voice->current.pitch >= AUDIO_OCTAVES * 12) continue;
+        if (voice->priority > best) {
+            best = voice->priority;
+            count = 0;
+        }
+        if (voice->priority == best) candidates[count++] = voice;
+    }
+    if (count == 0) return 0;
+    AudioVoice *voice = candidates[(now / AUDIO_ARPEGGIO_MS) % count];
+    return note_frequencies[voice->current.pitch];
+}
+
+static void set_output(AudioState *state, float frequency, float volume) {
+    if (frequency == state->output_frequency && volume == state->output_volume) return;
+    if (frequency == 0) {
+        notification_message(state->notification_app, &sequence_reset_sound);
+    } else {
+        //the tone keeps playing after the sequence, until the next one
+        AudioOutput *output = &(state->outputs[state->output_slot++ & (AUDIO_OUTPUT_SLOTS - 1)]);
+        output->message = (NotificationMessage) {
+            .type=NotificationMessageTypeSoundOn,
+            .data.sound={.frequency=frequency, .volume=volume},
+        };
+        output->sequence[0] = &(output->message);
+        output->sequence[1] = &message_do_not_reset;
+        output->sequence[2] = NULL;
+        notification_message(state->notification_app, (const NotificationSequence *) &(output->sequence));
+    }
+    state->output_frequency = frequency;
+    state->output_volume = volume;
+}
+
+static void set_vibro(AudioState *state, bool vibro) {
+    if (vibro == state->vibro) return;
+    notification_message(state->notification_app, vibro ? &sequence_set_vibro_on : &sequence_reset_vibro);
+    state->vibro = vibro;
+}
+
+static bool voices_active(AudioState *state) {
+    if (state->music.active) return true;
+    for (uint8_t i = 0; i < AUDIO_SFX_VOICES; i++) {
+        if (state->sfx[i].active) return true;
+    }
+    return false;
+}
+
+static void silence(AudioState *state) {
+    set_output(state, 0, 0);
+    set_vibro(state, false);
+}
+
+// false if the tick has to end here
+static bool run_command(AudioState *state, uint32_t now) {
+    switch (state->command) {
+        case AudioCommandStopMusic:
+            state->music.active = false;
+            state->music_playing = false;
+            state->command = AudioCommandNone;
+            return true;
+        case AudioCommandShutdown:
+            state->music.active = false;
+            for (uint8_t i = 0; i < AUDIO_SFX_VOICES; i++) {
+                state->sfx[i].active = false;
+            }
+            state->vibro_until = now;
+            silence(state);
+            state->idle = true;
+            state->command = AudioCommandNone;
+            return false;
+        default:
+            return true;
+    }
+}
+
+static void sequencer_tick(void *context) {
+    AudioState *state = context;
+    const uint32_t now = furi_get_tick();
+
+    if (!run_command(state, now)) return;
+    take_requests(state, now);
+
+    voice_advance(state, &(state->music), now);
+    for (uint8_t i = 0; i < AUDIO_SFX_VOICES; i++) {
+        voice_advance(state, &(state->sfx[i]), now);
+    }
+
+    set_vibro(state, (int32_t) (state->vibro_until - now) > 0);
+
+    if (!voices_active(state)) {
+        set_output(state, 0, 0);
+        state->idle = !state->vibro;
         return;
+    }
+    state->idle = false;
+    const float volume = state->muted ? 0 : state->volume;
+    set_output(state, volume > 0 ? arbitrate(state, now) : 0, volume);
+}
+
+// engine thread side
+
+static void queue_push(AudioState *state, AudioEvent event) {
+    state->queue[state->queue_head & (AUDIO_LOOKAHEAD - 1)] = event;
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    state->queue_head++;
+}
 
-    size_t t = furi_get_tick();
-    if ((t - last_start) > next_note) {
-        Beat curr = decode_note(current_music->music_notes[current_note]);
-        if (curr.note == NOTE_END) {
-            current_note = 0;
-            curr = decode_note(current_music->music_notes[current_note]);
+// the next note of the music source, false at its end
+static bool next_beat(AudioState *state, Beat *beat, bool *from_start) {
+    if (music_stream_is_open(&(state->stream))) {
+        if (music_stream_next(&(state->stream), beat)) return true;
+        if (!state->stream.loop || *from_start) return false;
+        music_stream_rewind(&(state->stream));
+        *from_start = true;
+        return music_stream_next(&(state->stream), beat);
+    }
+
+    MusicData *music = state->current_music;
+    *beat = decode_note(music->music_notes[state->next_note]);
+    if (beat->note == NOTE_END) {
+        if (!music->loop || state->next_note == 0) return false;
+        state->next_note = 0;
+        *beat = decode_note(music->music_notes[0]);
+        if (beat->note == NOTE_END) return false;
+    }
+    state->next_note++;
+    return true;
+}
+
+static void decode_ahead(AudioState *state) {
+    while (!state->decoded_end && queue_count(state) < AUDIO_LOOKAHEAD) {
+        Beat beat;
+        bool from_start = false;
+        if (!next_beat(state, &beat, &from_start)) {
+            queue_push(state, (AudioEvent) {.pitch=AUDIO_PITCH_END});
+            state->decoded_end = true;
+            break;
         }
 
-        delay.data.delay.length = (int) floorf(current_bpm * curr.beat_length);
-        next_note = delay.data.delay.length;
-        delay.data.delay.length -= current_separation;
-
-        if (curr.note < 12) {
-            note.data.sound.frequency = get_frequency(&curr);
-            note.type = NotificationMessageTypeSoundOn;
-            off.type = NotificationMessageTypeSoundOff;
-        } else if (curr.note == NOTE_NONE) {
-            note.type = NotificationMessageTypeSoundOff;
-        } else if (curr.note == NOTE_BUZZ) {
-            note.type = NotificationMessageTypeVibro;
-            note.data.vibro.on = true;
-            off.type = NotificationMessageTypeVibro;
-            off.data.vibro.on = false;
+        uint16_t duration = (uint16_t) floorf(state->beat_ms * beat.beat_length);
+        uint16_t gap = MIN(state->separation_ms, duration);
+        AudioEvent event = {.length=duration - gap, .gap=gap};
+        if (beat.note < 12) {
+            uint8_t octave = beat.octave < AUDIO_OCTAVES ? beat.octave : AUDIO_OCTAVES - 1;
+            event.pitch = octave * 12 + beat.note;
+        } else if (beat.note == NOTE_BUZZ) {
+            event.pitch = AUDIO_PITCH_BUZZ;
+        } else {
+            event.pitch = AUDIO_PITCH_REST;
         }
+        queue_push(state, event);
+    }
+}
 
-        notification_message(notification_app, (const NotificationSequence *) &music_sequence);
+static bool requests_pending(AudioState *state) {
+    return state->music_start || state->vibro_request || state->sfx_head != state->sfx_tail ||
+           state->command != AudioCommandNone;
+}
+
+// restarts the sequencer after a request was queued
+static void wake_sequencer(AudioState *state) {
+    if (!state->timer || state->timer_running) return;
+    state->idle = false;
+    furi_timer_start(state->timer, SEQUENCER_PERIOD);
+    state->timer_running = true;
+}
+
+// the timer only runs while something plays, requests are only made on this thread
+static void sleep_sequencer(AudioState *state) {
+    if (!state->timer_running || !state->idle || requests_pending(state)) return;
+    furi_timer_stop(state->timer);
+    state->timer_running = false;
+    //a tick before the stop may have started a request
+    if (!state->idle) wake_sequencer(state);
+}
+
+// waits until the sequencer has taken the command, a stopped sequencer runs it right away
+// false if the sequencer did not answer in time, the command is dropped then
+static bool send_command(AudioState *state, AudioCommand command) {
+    state->command = command;
+    if (!state->timer_running) {
+        run_command(state, furi_get_tick());
+        return true;
+    }
+    for (uint8_t i = 0; i < COMMAND_TIMEOUT && state->command != AudioCommandNone; i++) {
+        furi_delay_ms(1);
+    }
+    if (state->command == AudioCommandNone) return true;
+    state->command = AudioCommandNone;
+    FURI_LOG_W("AUDIO", "The sequencer did not take command %d", command);
+    return false;
+}
 
-        last_start = t;
-        current_note++;
+void setup_audio(NotificationApp *notification_app) {
+    AudioState *state = audio_state();
+    state->enabled = notification_app != NULL;
+    state->notification_app = notification_app;
+    state->music.active = false;
+    for (uint8_t i = 0; i < AUDIO_SFX_VOICES; i++) {
+        state->sfx[i].active = false;
     }
+    state->sfx_head = 0;
+    state->sfx_tail = 0;
+    state->vibro = false;
+    state->vibro_until = furi_get_tick();
+    state->output_frequency = 0;
+    state->output_volume = 0;
+    state->idle = true;
+    if (state->enabled && !state->timer) {
+        state->timer = furi_timer_alloc(sequencer_tick, FuriTimerTypePeriodic, state);
+        state->timer_running = false;
+    }
+}
+
+void cleanup_audio() {
+    AudioState *state = audio_state();
+    if (!state->timer) return;
+    if (!send_command(state, AudioCommandShutdown)) {
+        //once the timer is stopped no tick can run, the shutdown is done here instead
+        furi_timer_stop(state->timer);
+        state->timer_running = false;
+        state->command = AudioCommandShutdown;
+        run_command(state, furi_get_tick());
+    }
+    music_stream_close(&(state->stream));
+    furi_timer_free(state->timer);
+    state->timer = NULL;
+    state->timer_running = false;
+    state->music_playing = false;
+}
+
+void set_volume(float volume) {
+    audio_state()->volume = volume > 1.0f ? 1.0f : (volume < 0.0f ? 0.0f : volume);
+}
+
+void set_muted(bool muted) {
+    audio_state()->muted = muted;
+}
+
+static void set_tempo(AudioState *state, uint8_t bpm, float separation) {
+    state->beat_ms = get_delay(bpm);
+    state->separation_ms = (uint16_t) floorf(state->beat_ms * separation);
+}
+
+void set_audio(MusicData *data) {
+    AudioState *state = audio_state();
+    stop_audio();
+    music_stream_close(&(state->stream));
+    state->current_music = data;
+    set_tempo(state, data->bpm, data->separation);
+}
+
+void update_audio() {
+    AudioState *state = audio_state();
+    if (state->music_playing) decode_ahead(state);
+    sleep_sequencer(state);
+}
+
+static void start_music(AudioState *state) {
+    state->next_note = 0;
+    state->decoded_end = false;
+    state->queue_head = 0;
+    state->queue_tail = 0;
+    decode_ahead(state);
+
+    //the first note comes after one beat
+    state->music_start_tick = furi_get_tick() + (uint32_t) state->beat_ms;
+    state->music_playing = true;
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    state->music_start = true;
+    wake_sequencer(state);
 }
 
 void play_audio() {
-    stopped = false;
-    looped = false;
-    last_start = furi_get_tick();
-    next_note = (int) floorf(current_bpm);
-    current_note = 0;
+    AudioState *state = audio_state();
+    if (!state->enabled) return;
+    stop_audio();
+    if (music_stream_is_open(&(state->stream))) {
+        music_stream_rewind(&(state->stream));
+    } else if (!state->current_music) {
+        return;
+    }
+    start_music(state);
+}
+
+bool play_audio_file(const char *path) {
+    AudioState *state = audio_state();
+    if (!state->enabled) return false;
+    stop_audio();
+    if (!music_stream_open(&(state->stream), path)) return false;
+    set_tempo(state, state->stream.bpm, state->stream.separation);
+    start_music(state);
+    return true;
 }
 
 void stop_audio() {
-    stopped = true;
-}
\ No newline at end of file
+    AudioState *state = audio_state();
+    if (!state->timer) return;
+    state->music_start = false;
+    send_command(state, AudioCommandStopMusic);
+}
+
+bool is_music_playing() {
+    return audio_state()->music_playing;
+}
+
+void audio_set_effects(const SoundEffect *effects, uint8_t count) {
+    AudioState *state = audio_state();
+    state->effects = effects;
+    state->effect_count = count;
+}
+
+void audio_play_effect(uint8_t id) {
+    AudioState *state = audio_state();
+    if (!state->timer || id >= state->effect_count) return;
+    if ((uint8_t) (state->sfx_head - state->sfx_tail) == AUDIO_SFX_REQUESTS) return;
+    state->sfx_requests[state->sfx_head & (AUDIO_SFX_REQUESTS - 1)] = id;
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    state->sfx_head++;
+    wake_sequencer(state);
+}
+
+void audio_vibrate(uint16_t ms) {
+    AudioState *state = audio_state();
+    if (!state->timer) return;
+    state->vibro_request = ms;
+    wake_sequencer(state);
+}
@@ -1,5 +1,7 @@
 #pragma once
+#include <furi.h>
 #include <notification/notification.h>
+#include "music_stream.h"
 
 // Macro to scale the note length to a 16-bit integer (0-4 range)
 #define SCALE_NOTE_LENGTH(note_length) \
@@ -28,7 +30,7 @@ typedef enum {
     NOTE_NONE = 14,
 } Note;
 
-typedef struct {
+typedef struct Beat {
     Note note;
     uint8_t octave;
     float beat_length;
@@ -42,14 +44,158 @@ typedef struct {
     bool loop;          // automatically restart the music if it reaches the end
 } MusicData;
 
+// music is pre-decoded into these events, the sequencer timer plays them from a small queue
+#define AUDIO_LOOKAHEAD 16 // power of two
+#define AUDIO_OCTAVES 9
+#define AUDIO_PITCH_REST 0xFF
+#define AUDIO_PITCH_BUZZ 0xFE
+#define AUDIO_PITCH_END 0xFD
+
+typedef struct {
+    uint8_t pitch;      // octave * 12 + note, or one of AUDIO_PITCH_*
+    uint16_t length;    // ms of sound
+    uint16_t gap;       // ms of silence after it
+} AudioEvent;
+
+// short sounds played over the music, buzz events go to the vibro motor
+// the voice with the highest priority gets the speaker, equal priorities are arpeggiated
+#define AUDIO_SFX_VOICES 3
+#define AUDIO_SFX_REQUESTS 8 // power of two
+#define AUDIO_ARPEGGIO_MS 16
+#define AUDIO_MUSIC_PRIORITY 0
+
+typedef struct {
+    const AudioEvent *events;
+    uint8_t count;
+    uint8_t priority;   // above AUDIO_MUSIC_PRIORITY
+} SoundEffect;
+
+// octave 0 to AUDIO_OCTAVES - 1, higher pitches play in the top octave
+#define SFX_TONE(note, octave, ms) {.pitch=(octave) * 12 + (note), .length=ms, .gap=0}
+#define SFX_REST(ms) {.pitch=AUDIO_PITCH_REST, .length=ms, .gap=0}
+#define SFX_BUZZ(ms) {.pitch=AUDIO_PITCH_BUZZ, .length=ms, .gap=0}
+#define MAKE_SOUND_EFFECT(event_array, effect_priority) (SoundEffect){ \
+    .events=event_array, \
+    .count=sizeof(event_array) / sizeof(AudioEvent), \
+    .priority=effect_priority \
+}
+
+// a sequence of events, owned by the sequencer timer
+typedef struct {
+    bool active;
+    bool sounding;
+    uint8_t priority;
+    const SoundEffect *effect;  // NULL for the music voice, it reads the lookahead queue
+    uint8_t position;
+    uint32_t started;
+    AudioEvent current;
+    uint32_t phase_end;         // tick when the sound or the gap of the current event ends
+} AudioVoice;
+
+typedef enum {
+    AudioCommandNone,
+    AudioCommandStopMusic,
+    AudioCommandShutdown,
+} AudioCommand;
+
+// Tones are sent to the notification service, which owns the speaker and applies the system sound settings
+// (volume, stealth mode). The service reads the message later, so a few of them are kept in a ring.
+#define AUDIO_OUTPUT_SLOTS 8 // power of two
+
+typedef struct {
+    NotificationMessage message;
+    const NotificationMessage *sequence[3];
+} AudioOutput;
+
+// per engine context state of the music player and the mixer
+typedef struct {
+    bool enabled;       // false in headless mode
+    NotificationApp *notification_app;
+    volatile float volume;
+    volatile bool muted;
+    MusicData *current_music;
+    MusicStream stream;             // open while a music file is the source
+
+    // decoder, runs on the engine thread (play_audio and update_audio)
+    uint32_t next_note;
+    float beat_ms;
+    uint16_t separation_ms;
+    bool decoded_end;
+    AudioEvent queue[AUDIO_LOOKAHEAD];
+    volatile uint8_t queue_head;    // written by the decoder
+    volatile uint8_t queue_tail;    // written by the sequencer
+
+    // requests of the engine thread, consumed by the sequencer
+    volatile AudioCommand command;
+    volatile bool music_start;
+    volatile bool music_playing;
+    volatile uint32_t music_start_tick;
+    volatile uint16_t vibro_request;    // ms
+    const SoundEffect *effects;
+    uint8_t effect_count;
+    uint8_t sfx_requests[AUDIO_SFX_REQUESTS];
+    volatile uint8_t sfx_head;
+    volatile uint8_t sfx_tail;
+
+    // sequencer, runs on the timer while something plays, update_audio stops it once it reports idle
+    FuriTimer *timer;
+    bool timer_running;
+    volatile bool idle;
+    AudioVoice music;
+    AudioVoice sfx[AUDIO_SFX_VOICES];
+    uint32_t vibro_until;
+    bool vibro;
+    float output_frequency;         // what the speaker plays, 0 = silent
+    float output_volume;
+    AudioOutput outputs[AUDIO_OUTPUT_SLOTS];
+    uint8_t output_slot;
+} AudioState;
+
+#define DEFAULT_AUDIO_STATE { \
+    .enabled=false, \
+    .volume=1, \
+    .muted=false, \
+    .current_music=NULL, \
+    .stream={.storage=NULL, .file=NULL}, \
+    .command=AudioCommandNone, \
+    .music_start=false, \
+    .music_playing=false, \
+    .effects=NULL, \
+    .effect_count=0, \
+    .timer=NULL, \
+    .timer_running=false, \
+    .idle=true \
+}
+
 void set_audio(MusicData *music);
 
 void play_audio();
 
+// streams a music file made by tools/music/music_convert.py instead of the MusicData set by set_audio
+bool play_audio_file(const char *path);
+
+// keeps the lookahead queue filled and stops the sequencer while nothing plays, called by the engine every frame
 void update_audio();
 
 void stop_audio();
 
+bool is_music_playing();
+
+// NULL disables the audio (headless mode), the speaker and the vibro motor are driven through the notification app
 void setup_audio(NotificationApp *notification_app);
 
-void set_volume(float volume);
\ No newline at end of file
+void cleanup_audio();
+
+// master volume of the speaker 0-1, applies to the music and the effects
+void set_volume(float volume);
+
+void set_muted(bool muted);
+
+// the table is not copied, keep it alive while audio is set up
+void audio_set_effects(const SoundEffect *effects, uint8_t count);
+
+// starts an effect of the table, does not allocate, dropped if every voice plays a higher priority effect
+void audio_play_effect(uint8_t id);
+
+// runs the vibro motor, independent of the music and the effects
+void audio_vibrate(uint16_t ms);
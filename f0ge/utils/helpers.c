@@ -3,7 +3,12 @@
 #include <furi.h>
 #include <math.h>
 
+#ifdef F0GE_HOST
+// host tools allocate from several engine contexts at once
+static _Atomic int32_t pointer_count=0;
+#else
 int16_t pointer_count=0;
+#endif
 
 bool _test_ptr(void *p) {
     return p != NULL;
@@ -30,7 +35,17 @@ char *get_basename(const char *path) {
     return (char *) base;
 }
 
+#ifdef F0GE_HOST
+#include <time.h>
+
+size_t curr_time() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (size_t) (((uint64_t) ts.tv_sec * 1000000000u + ts.tv_nsec) * CYCLES_PER_US / 1000u);
+}
+#else
 size_t curr_time() { return DWT->CYCCNT; }
+#endif
 
 void *_allocate(size_t size, const char *file, int line, const char *func) {
     pointer_count++;
@@ -60,7 +75,7 @@ void check_leak(){
 Timer* timer_start(const char*name) {
     Timer *t = malloc(sizeof(Timer));
     t->name = name;
-    t->start = DWT->CYCCNT;
+    t->start = curr_time();
     return t;
 }
 
@@ -68,8 +83,8 @@ const char *format[3] = {"us", "ms", "s"};
 size_t timer_end(Timer *t) {
     int8_t i = 0;
     uint32_t start = t->start;
-    uint32_t diff = (DWT->CYCCNT - start);
-    double d = (double)diff/ (double)64.0;
+    uint32_t diff = (uint32_t) curr_time() - start;
+    double d = (double)diff/ (double)CYCLES_PER_US;
     while (d >= (double)1000.0) {
         d /= (double)1000.0;
         i++;
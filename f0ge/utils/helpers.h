@@ -24,6 +24,12 @@ char *get_basename(const char *path);
 #define basename(path) get_basename(path)
 #endif
 
+// curr_time counts cpu cycles at 64MHz, host builds emulate the same rate
+#define CYCLES_PER_US 64
+
+// rounds a size up to the next multiple of 8, for structures packed into one block
+#define ALIGN8(x) (((x) + 7) & ~((size_t) 7))
+
 #define CHECK_HEAP() FURI_LOG_W("Stat", "Free/total heap: %zu / %zu", memmgr_get_free_heap(), memmgr_get_total_heap())
 
 bool _test_ptr(void *p);
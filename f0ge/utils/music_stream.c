@@ -0,0 +1,153 @@
+#include "music_stream.h"
+#include "audio.h"
+
+static const uint8_t music_magic[4] = {'F', '0', 'M', 'U'};
+
+static bool read_u8(MusicStream *stream, uint8_t *value) {
+    if (stream->buffer_pos == stream->buffer_len) {
+        stream->buffer_offset += stream->buffer_len;
+        stream->buffer_len = storage_file_read(stream->file, stream->buffer, MUSIC_STREAM_BUFFER);
+        stream->buffer_pos = 0;
+        if (stream->buffer_len == 0) return false;
+    }
+    *value = stream->buffer[stream->buffer_pos++];
+    return true;
+}
+
+static bool read_u16(MusicStream *stream, uint16_t *value) {
+    uint8_t low, high;
+    if (!read_u8(stream, &low) || !read_u8(stream, &high)) return false;
+    *value = low | (high << 8);
+    return true;
+}
+
+static bool read_u32(MusicStream *stream, uint32_t *value) {
+    uint16_t low, high;
+    if (!read_u16(stream, &low) || !read_u16(stream, &high)) return false;
+    *value = low | ((uint32_t) high << 16);
+    return true;
+}
+
+static inline uint32_t position(MusicStream *stream) {
+    return stream->buffer_offset + stream->buffer_pos;
+}
+
+static bool seek(MusicStream *stream, uint32_t offset) {
+    //jumps back into a pattern are often still buffered
+    if (offset >= stream->buffer_offset && offset < stream->buffer_offset + stream->buffer_len) {
+        stream->buffer_pos = offset - stream->buffer_offset;
+        return true;
+    }
+    stream->buffer_offset = offset;
+    stream->buffer_pos = 0;
+    stream->buffer_len = 0;
+    return storage_file_seek(stream->file, offset, true);
+}
+
+static bool read_header(MusicStream *stream) {
+    uint8_t header[9];
+    for (uint8_t i = 0; i < 9; i++) {
+        if (!read_u8(stream, &header[i])) return false;
+    }
+    if (memcmp(header, music_magic, 4) != 0 || header[4] != MUSIC_STREAM_VERSION) return false;
+    stream->loop = header[5] & 1;
+    stream->bpm = header[6];
+    stream->separation = header[7] / 255.0f;
+    if (stream->bpm == 0 || header[8] > MUSIC_STREAM_LENGTHS) return false;
+
+    for (uint8_t i = 0; i < MUSIC_STREAM_LENGTHS; i++) {
+        stream->lengths[i] = 0;
+        if (i < header[8] && !read_u16(stream, &(stream->lengths[i]))) return false;
+    }
+    if (!read_u8(stream, &(stream->pattern_count)) || stream->pattern_count > MUSIC_STREAM_PATTERNS) return false;
+    for (uint8_t i = 0; i < stream->pattern_count; i++) {
+        if (!read_u32(stream, &(stream->patterns[i]))) return false;
+    }
+    return read_u32(stream, &(stream->song_offset));
+}
+
+bool music_stream_open(MusicStream *stream, const char *path) {
+    music_stream_close(stream);
+    stream->storage = furi_record_open(RECORD_STORAGE);
+    stream->file = storage_file_alloc(stream->storage);
+    stream->buffer_offset = 0;
+    stream->buffer_pos = 0;
+    stream->buffer_len = 0;
+    if (!storage_file_open(stream->file, path, FSAM_READ, FSOM_OPEN_EXISTING) || !read_header(stream)) {
+        FURI_LOG_E("MUSIC", "Cannot play %s", path);
+        music_stream_close(stream);
+        return false;
+    }
+    music_stream_rewind(stream);
+    return true;
+}
+
+void music_stream_close(MusicStream *stream) {
+    if (stream->file) {
+        storage_file_close(stream->file);
+        storage_file_free(stream->file);
+        stream->file = NULL;
+    }
+    if (stream->storage) {
+        furi_record_close(RECORD_STORAGE);
+        stream->storage = NULL;
+    }
+}
+
+bool music_stream_is_open(MusicStream *stream) {
+    return stream->file != NULL;
+}
+
+void music_stream_rewind(MusicStream *stream) {
+    stream->octave = 4;
+    stream->depth = 0;
+    seek(stream, stream->song_offset);
+}
+
+bool music_stream_next(MusicStream *stream, Beat *beat) {
+    uint8_t op;
+    while (read_u8(stream, &op)) {
+        if (op < 0x80) {
+            const uint8_t note = op & 0x0F;
+            const uint8_t length = (op >> 4) & 0x07;
+            uint16_t scaled = stream->lengths[length < MUSIC_STREAM_LENGTHS ? length : 0];
+            if (length == MUSIC_LENGTH_INLINE && !read_u16(stream, &scaled)) break;
+            if (note > 13) break;
+            beat->note = note < 12 ? (Note) note : (note == 12 ? NOTE_NONE : NOTE_BUZZ);
+            beat->octave = stream->octave;
+            beat->beat_length = ((float) scaled / 65535.0f) * 4.0f;
+            return true;
+        }
+        if ((op & 0xF0) == MUSIC_OP_OCTAVE) {
+            stream->octave = op & 0x0F;
+            continue;
+        }
+        if (op == MUSIC_OP_CALL) {
+            uint8_t pattern, repeats;
+            if (!read_u8(stream, &pattern) || !read_u8(stream, &repeats)) break;
+            if (pattern >= stream->pattern_count || repeats == 0 || stream->depth == MUSIC_STREAM_DEPTH) break;
+            stream->stack[stream->depth++] = (MusicStreamFrame) {
+                .return_offset=position(stream),
+                .pattern_offset=stream->patterns[pattern],
+                .repeats=repeats - 1,
+            };
+            if (!seek(stream, stream->patterns[pattern])) break;
+            continue;
+        }
+        if (op == MUSIC_OP_RETURN && stream->depth > 0) {
+            MusicStreamFrame *frame = &(stream->stack[stream->depth - 1]);
+            if (frame->repeats > 0) {
+                frame->repeats--;
+                if (!seek(stream, frame->pattern_offset)) break;
+            } else {
+                stream->depth--;
+                if (!seek(stream, frame->return_offset)) break;
+            }
+            continue;
+        }
+        if (op == MUSIC_OP_END) return false;
+        break;
+    }
+    FURI_LOG_E("MUSIC", "Broken music file at %lu", (unsigned long) position(stream));
+    return false;
+}
@@ -0,0 +1,65 @@
+#pragma once
+#include <furi.h>
+#include <storage/storage.h>
+
+typedef struct Beat Beat;
+
+// Compressed music files, made by tools/music/music_convert.py and decoded a few bytes at a time while playing.
+// Layout: "F0MU", version u8, flags u8 (bit 0: loop), bpm u8, separation u8 (beats * 255),
+//   length_count u8, lengths u16[length_count] (SCALE_NOTE_LENGTH), pattern_count u8 (up to 32), pattern u32[pattern_count],
+//   song u32 (file offsets), then the bodies of the patterns and the song:
+//   0lllnnnn        note n (0-11, 12 rest, 13 buzz), length l from the table, l = 7: scaled length u16 follows
+//   1000oooo        sets the octave of the next notes
+//   10010000 pp rr  plays pattern p r times
+//   10010001        end of a pattern
+//   11111111        end of the song
+#define MUSIC_STREAM_VERSION 1
+#define MUSIC_STREAM_BUFFER 64
+#define MUSIC_STREAM_LENGTHS 7
+#define MUSIC_STREAM_DEPTH 4
+#define MUSIC_STREAM_PATTERNS 32
+
+#define MUSIC_OP_OCTAVE 0x80
+#define MUSIC_OP_CALL 0x90
+#define MUSIC_OP_RETURN 0x91
+#define MUSIC_OP_END 0xFF
+#define MUSIC_LENGTH_INLINE 7
+
+typedef struct {
+    uint32_t return_offset;
+    uint32_t pattern_offset;
+    uint8_t repeats;        // left after the current one
+} MusicStreamFrame;
+
+typedef struct {
+    Storage *storage;
+    File *file;
+    uint8_t buffer[MUSIC_STREAM_BUFFER];
+    uint16_t buffer_pos;
+    uint16_t buffer_len;
+    uint32_t buffer_offset;     // file offset of buffer[0]
+
+    uint8_t bpm;
+    float separation;
+    bool loop;
+    uint16_t lengths[MUSIC_STREAM_LENGTHS];
+    uint8_t pattern_count;
+    uint32_t patterns[MUSIC_STREAM_PATTERNS];
+    uint32_t song_offset;
+
+    uint8_t octave;
+    MusicStreamFrame stack[MUSIC_STREAM_DEPTH];
+    uint8_t depth;
+} MusicStream;
+
+bool music_stream_open(MusicStream *stream, const char *path);
+
+void music_stream_close(MusicStream *stream);
+
+bool music_stream_is_open(MusicStream *stream);
+
+// starts the song again
+void music_stream_rewind(MusicStream *stream);
+
+// false at the end of the song or on a broken file
+bool music_stream_next(MusicStream *stream, Beat *beat);
@@ -0,0 +1,193 @@
+#include "replay.h"
+#include "helpers.h"
+#include "../context.h"
+#include "../f0ge.h"
+
+#define REPLAY_INPUT_TAG 0x80
+#define REPLAY_FRAME_TAG 0x00
+#define REPLAY_CHECKSUM_BIT 0x01
+
+static const uint8_t replay_magic[4] = {'F', '0', 'R', 'P'};
+
+static inline ReplayState *replay_state() {
+    return &(engine_context_current()->replay);
+}
+
+static void flush(ReplayState *state) {
+    if (state->buffer_pos == 0) return;
+    storage_file_write(state->file, state->buffer, state->buffer_pos);
+    state->buffer_pos = 0;
+}
+
+static void write_bytes(ReplayState *state, const uint8_t *data, uint16_t size) {
+    if (state->buffer_pos + size > REPLAY_BUFFER_SIZE) flush(state);
+    memcpy(state->buffer + state->buffer_pos, data, size);
+    state->buffer_pos += size;
+}
+
+static bool read_bytes(ReplayState *state, uint8_t *data, uint16_t size) {
+    for (uint16_t i = 0; i < size; i++) {
+        if (state->buffer_pos == state->buffer_len) {
+            state->buffer_len = storage_file_read(state->file, state->buffer, REPLAY_BUFFER_SIZE);
+            state->buffer_pos = 0;
+            if (state->buffer_len == 0) return false;
+        }
+        data[i] = state->buffer[state->buffer_pos++];
+    }
+    return true;
+}
+
+static bool open_log(ReplayState *state, const char *path, FS_AccessMode access, FS_OpenMode open) {
+    replay_stop();
+    state->storage = furi_record_open(RECORD_STORAGE);
+    state->file = storage_file_alloc(state->storage);
+    if (!storage_file_open(state->file, path, access, open)) {
+        FURI_LOG_E("REPLAY", "Cannot open %s", path);
+        storage_file_free(state->file);
+        state->file = NULL;
+        furi_record_close(RECORD_STORAGE);
+        state->storage = NULL;
+        return false;
+    }
+    state->buffer_pos = 0;
+    state->buffer_len = 0;
+    state->pending_count = 0;
+    state->frames = 0;
+    state->mismatches = 0;
+    return true;
+}
+
+bool replay_record_start(const char *path, bool checksums) {
+    ReplayState *state = replay_state();
+    if (!open_log(state, path, FSAM_WRITE, FSOM_CREATE_ALWAYS)) return false;
+
+    state->checksums = checksums;
+    write_bytes(state, replay_magic, 4);
+    const uint8_t header[2] = {REPLAY_VERSION, checksums ? REPLAY_CHECKSUM_BIT : 0};
+    write_bytes(state, header, 2);
+    state->mode = ReplayRecording;
+    return true;
+}
+
+bool replay_play_start(const char *path, bool exit_at_end) {
+    ReplayState *state = replay_state();
+    if (!open_log(state, path, FSAM_READ, FSOM_OPEN_EXISTING)) return false;
+
+    uint8_t header[6];
+    if (!read_bytes(state, header, 6) || memcmp(header, replay_magic, 4) != 0 || header[4] != REPLAY_VERSION) {
+        FURI_LOG_E("REPLAY", "%s is not a replay log", path);
+        replay_stop();
+        return false;
+    }
+    state->checksums = header[5] & REPLAY_CHECKSUM_BIT;
+    state->exit_at_end = exit_at_end;
+    state->mode = ReplayPlaying;
+    return true;
+}
+
+void replay_stop() {
+    ReplayState *state = replay_state();
+    if (state->file) {
+        if (state->mode == ReplayRecording) flush(state);
+        storage_file_close(state->file);
+        storage_file_free(state->file);
+        state->file = NULL;
+    }
+    if (state->storage) {
+        furi_record_close(RECORD_STORAGE);
+        state->storage = NULL;
+    }
+    if (state->mode == ReplayPlaying) {
+        FURI_LOG_I("REPLAY", "Played %lu frames, %lu mismatches", (unsigned long) state->frames,
+                   (unsigned long) state->mismatches);
+    }
+    state->mode = ReplayOff;
+}
+
+ReplayMode replay_mode() {
+    return replay_state()->mode;
+}
+
+uint32_t replay_mismatches() {
+    return replay_state()->mismatches;
+}
+
+bool replay_accepts_input(InputKey key, InputType type) {
+    if (replay_state()->mode != ReplayPlaying) return true;
+    return key == InputKeyBack && type == InputTypeLong;
+}
+
+void replay_record_input(InputKey key, InputType type) {
+    ReplayState *state = replay_state();
+    if (state->mode != ReplayRecording) return;
+    if (state->pending_count == sizeof(state->pending)) {
+        FURI_LOG_W("REPLAY", "Too many input events in one frame, dropped");
+        return;
+    }
+    state->pending[state->pending_count++] = REPLAY_INPUT_TAG | (key << 3) | type;
+}
+
+// applies the logged input up to the next frame record and returns its delta
+static uint32_t play_frame(ReplayState *state, uint32_t delta) {
+    uint8_t tag;
+    while (read_bytes(state, &tag, 1)) {
+        if (tag & REPLAY_INPUT_TAG) {
+            engine_inject_input((tag >> 3) & 0x0F, tag & 0x07);
+            continue;
+        }
+
+        uint8_t data[6];
+        const uint8_t size = (tag & REPLAY_CHECKSUM_BIT) ? 6 : 2;
+        if (!read_bytes(state, data, size)) break;
+        state->frame_has_checksum = tag & REPLAY_CHECKSUM_BIT;
+        if (state->frame_has_checksum) {
+            state->frame_checksum = data[2] | (data[3] << 8) | (data[4] << 16) | ((uint32_t) data[5] << 24);
+        }
+        return data[0] | (data[1] << 8);
+    }
+
+    // end of the log, the frame runs live
+    const bool exit_at_end = state->exit_at_end;
+    replay_stop();
+    if (exit_at_end) engine_exit();
+    return delta;
+}
+
+uint32_t replay_frame_begin(uint32_t delta) {
+    ReplayState *state = replay_state();
+    switch (state->mode) {
+        case ReplayRecording:
+            write_bytes(state, state->pending, state->pending_count);
+            state->pending_count = 0;
+            // longer frames are clamped, they would replay as a different frame anyway
+            state->frame_delta = MIN(delta, UINT16_MAX);
+            return state->frame_delta;
+        case ReplayPlaying:
+            return play_frame(state, delta);
+        default:
+            return delta;
+    }
+}
+
+void replay_frame_end(Buffer *buffer) {
+    ReplayState *state = replay_state();
+    if (state->mode == ReplayRecording) {
+        const uint16_t delta = state->frame_delta;
+        uint8_t record[7] = {REPLAY_FRAME_TAG, delta & 0xFF, delta >> 8};
+        uint8_t size = 3;
+        if (state->checksums) {
+            const uint32_t hash = buffer_checksum(buffer);
+            record[0] |= REPLAY_CHECKSUM_BIT;
+            for (uint8_t i = 0; i < 4; i++) record[3 + i] = (hash >> (i * 8)) & 0xFF;
+            size = 7;
+        }
+        write_bytes(state, record, size);
+        state->frames++;
+    } else if (state->mode == ReplayPlaying) {
+        if (state->frame_has_checksum && buffer_checksum(buffer) != state->frame_checksum) {
+            FURI_LOG_W("REPLAY", "Frame %lu differs from the recording", (unsigned long) state->frames);
+            state->mismatches++;
+        }
+        state->frames++;
+    }
+}
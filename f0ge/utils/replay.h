@@ -0,0 +1,71 @@
+#pragma once
+#include <furi.h>
+#include <input/input.h>
+#include <storage/storage.h>
+#include "../graphics/buffer.h"
+
+// Records the input events and the frame deltas of a run, playing them back renders the same frames again.
+// Start the playback at the same point of the game as the recording (eg. right after set_scene).
+// Log format: "F0RP", version byte, flags byte, then records:
+//   1kkkkttt                           input event, key and type
+//   0000000c dd dd [cc cc cc cc]       frame, delta in ms (u16 le), checksum of the frame if the c bit is set
+#define REPLAY_VERSION 1
+#define REPLAY_BUFFER_SIZE 256
+
+typedef enum {
+    ReplayOff,
+    ReplayRecording,
+    ReplayPlaying,
+} ReplayMode;
+
+// per engine context state of the recorder/player
+typedef struct {
+    ReplayMode mode;
+    bool checksums;
+    bool exit_at_end;
+    Storage *storage;
+    File *file;
+    // file io goes through this buffer, records are a few bytes each
+    uint8_t buffer[REPLAY_BUFFER_SIZE];
+    uint16_t buffer_pos;
+    uint16_t buffer_len;
+    // live input that arrived since the last frame, written before the next frame record
+    uint8_t pending[16];
+    uint8_t pending_count;
+    uint16_t frame_delta;
+    bool frame_has_checksum;
+    uint32_t frame_checksum;
+    uint32_t frames;
+    uint32_t mismatches;
+} ReplayState;
+
+#define DEFAULT_REPLAY_STATE { \
+    .mode=ReplayOff, \
+    .storage=NULL, \
+    .file=NULL \
+}
+
+// starts logging from the next frame, checksums stores the hash of every frame to verify the playback
+bool replay_record_start(const char *path, bool checksums);
+
+// feeds the log back from the next frame, live input is ignored meanwhile (except the long back press)
+bool replay_play_start(const char *path, bool exit_at_end);
+
+// closes the log, called by cleanup_engine too
+void replay_stop();
+
+ReplayMode replay_mode();
+
+// played frames whose checksum did not match the recorded one
+uint32_t replay_mismatches();
+
+// engine hooks
+// false if a live input event has to be ignored
+bool replay_accepts_input(InputKey key, InputType type);
+
+void replay_record_input(InputKey key, InputType type);
+
+// returns the delta to use for the frame in ms
+uint32_t replay_frame_begin(uint32_t delta);
+
+void replay_frame_end(Buffer *buffer);
@@ -1,26 +1,29 @@
 #include "scheduler.h"
 #include "list.h"
-
-static List *schedules = NULL;
-static RuntimeData *scheduler_runtime_data;
+#include "../context.h"
 
 void scheduler_prepare(RuntimeData *sceneData) {
-    if (!schedules) {
-        schedules = list_make();
+    UNUSED(sceneData);
+    EngineContext *context = engine_context_current();
+    if (!context->schedules) {
+        context->schedules = list_make();
     }
-    scheduler_runtime_data = sceneData;
 }
 
 void scheduler_cleanup() {
-    list_free(schedules);
+    EngineContext *context = engine_context_current();
+    list_free(context->schedules);
+    context->schedules = NULL;
 }
 
 void scheduler_start(Scheduler *scheduler) {
     scheduler->t = 0;
-    list_push_back(scheduler, schedules);
+    list_push_back(scheduler, engine_context_current()->schedules);
 }
 
 void scheduler_update() {
+    EngineContext *context = engine_context_current();
+    List *schedules = context->schedules;
     if (!schedules) return;
 
     ListItem *start = schedules->head;
@@ -28,11 +31,11 @@ void scheduler_update() {
         Scheduler *current_scheduler = (Scheduler *) start->data;
         start = start->next;
 
-        current_scheduler->t += scheduler_runtime_data->delta_time;
+        current_scheduler->t += context->runtime.delta_time;
 
         if (current_scheduler->t >= current_scheduler->timeout) {
             current_scheduler->t = 0;
-            current_scheduler->callback(current_scheduler->data, scheduler_runtime_data);
+            current_scheduler->callback(current_scheduler->data, &(context->runtime));
             if (!current_scheduler->repeat) {
                 list_remove_item(current_scheduler, schedules);
             }
@@ -42,11 +45,13 @@ void scheduler_update() {
 }
 
 void scheduler_stop(Scheduler *scheduler) {
+    List *schedules = engine_context_current()->schedules;
     if (!schedules) return;
 
     ListItem *start = schedules->head;
     while (start) {
         Scheduler *current_scheduler = (Scheduler *) start->data;
+        start = start->next;
         if (scheduler == current_scheduler) {
             list_remove_item(current_scheduler, schedules);
         }
@@ -55,5 +60,5 @@ void scheduler_stop(Scheduler *scheduler) {
 }
 
 void scheduler_stop_all() {
-    list_clear(schedules);
-}
\ No newline at end of file
+    list_clear(engine_context_current()->schedules);
+}
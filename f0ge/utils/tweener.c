@@ -1,17 +1,18 @@
 #include "tweener.h"
 #include "helpers.h"
-
-static List *tweeners = NULL;
-static RuntimeData *tweener_runtime_data;
+#include "../context.h"
 
 void tweener_prepare(RuntimeData *data) {
-    if (!tweeners)
-        tweeners = list_make();
-    tweener_runtime_data = data;
+    UNUSED(data);
+    EngineContext *context = engine_context_current();
+    if (!context->tweeners)
+        context->tweeners = list_make();
 }
 
 void tweener_cleanup() {
-    list_free(tweeners);
+    EngineContext *context = engine_context_current();
+    list_free(context->tweeners);
+    context->tweeners = NULL;
 }
 
 void tweener_start(Tweener *tweener) {
@@ -19,10 +20,12 @@ void tweener_start(Tweener *tweener) {
     tweener->finished = false;
     tweener->finished = tweener->update(tweener);
 
-    list_push_back(tweener, tweeners);
+    list_push_back(tweener, engine_context_current()->tweeners);
 }
 
 void tweener_update() {
+    EngineContext *context = engine_context_current();
+    List *tweeners = context->tweeners;
     if (!tweeners) return;
 
     ListItem *start = tweeners->head;
@@ -32,7 +35,7 @@ void tweener_update() {
         start = start->next;
         if (data) {
             if (data->delay <= 0) {
-                data->t += tweener_runtime_data->delta_time * (1.f / data->length);
+                data->t += context->runtime.delta_time * (1.f / data->length);
                 if (data->t > 1) data->t = 1;
                 data->finished = data->update(data) || data->t == 1;
                 if (data->finished) {
@@ -40,7 +43,7 @@ void tweener_update() {
                     list_remove_item(data, tweeners);
                 }
             } else {
-                data->delay -= tweener_runtime_data->delta_time;
+                data->delay -= context->runtime.delta_time;
             }
         }
     }
@@ -52,5 +55,5 @@ void tweener_end(Tweener *tweener) {
     tweener->finished=true;
     tweener->t=1;
     tweener->end(tweener);
-    list_remove_item(tweener, tweeners);
-}
\ No newline at end of file
+    list_remove_item(tweener, engine_context_current()->tweeners);
+}
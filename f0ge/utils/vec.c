@@ -0,0 +1,37 @@
+#include "vec.h"
+#include "helpers.h"
+
+void vec_push(Vec *vec, void *item) {
+    if (!vec->heap && vec->count < VEC_INLINE_CAPACITY) {
+        vec->inline_items[vec->count++] = item;
+        return;
+    }
+
+    if (!vec->heap || vec->count == vec->capacity) {
+        const uint16_t capacity = vec->heap ? vec->capacity * 2 : VEC_INLINE_CAPACITY * 2;
+        void **storage = allocate(sizeof(void *) * capacity);
+        check_pointer(storage);
+        memcpy(storage, vec_data(vec), sizeof(void *) * vec->count);
+        if (vec->heap) release(vec->heap);
+        vec->heap = storage;
+        vec->capacity = capacity;
+    }
+    vec->heap[vec->count++] = item;
+}
+
+bool vec_remove(Vec *vec, void *item) {
+    void **data = vec_data(vec);
+    for (uint16_t i = 0; i < vec->count; i++) {
+        if (data[i] != item) continue;
+        memmove(&data[i], &data[i + 1], sizeof(void *) * (vec->count - i - 1));
+        vec->count--;
+        return true;
+    }
+    return false;
+}
+
+void vec_clear(Vec *vec) {
+    if (vec->heap) release(vec->heap);
+    vec->count = 0;
+    vec->capacity = 0;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <furi.h>
+
+// elements kept inside the struct before spilling to the heap
+#define VEC_INLINE_CAPACITY 4
+
+// Growable array of pointers, small ones never allocate. A zeroed Vec is a valid empty one.
+// Elements must not be added or removed while iterating.
+typedef struct {
+    uint16_t count;
+    uint16_t capacity;  // of the heap storage
+    void **heap;        // NULL while the elements fit inline
+    void *inline_items[VEC_INLINE_CAPACITY];
+} Vec;
+
+#define EMPTY_VEC { \
+    .count=0, \
+    .capacity=0, \
+    .heap=NULL \
+}
+
+// for (var : vec), var is a void* that converts to the element type on assignment
+#define VEC_FOREACH(var, vec) \
+    for (void **var##_slot = vec_data(vec), **var##_end = var##_slot + (vec)->count, *var = NULL; \
+         var##_slot < var##_end && ((var = *var##_slot), true); var##_slot++)
+
+static inline void **vec_data(Vec *vec) {
+    return vec->heap ? vec->heap : vec->inline_items;
+}
+
+static inline void *vec_at(Vec *vec, uint16_t index) {
+    return vec_data(vec)[index];
+}
+
+void vec_push(Vec *vec, void *item);
+
+// keeps the order of the remaining elements, false if the item was not found
+bool vec_remove(Vec *vec, void *item);
+
+// empties the vec and releases the heap storage, not the elements
+void vec_clear(Vec *vec);
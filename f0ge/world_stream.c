@@ -0,0 +1,150 @@
+#include "world_stream.h"
+#include "f0ge.h"
+#include "utils/helpers.h"
+
+static void world_stream_update(Node *self, float delta, void *data);
+
+static inline int16_t chunk_coordinate(float position, float chunk_size) {
+    return (int16_t) floorf(position / chunk_size);
+}
+
+static Vector view_center() {
+    Vector camera = get_camera();
+    return (Vector){camera.x + SCREEN_WIDTH / 2, camera.y + SCREEN_HEIGHT / 2};
+}
+
+static float chunk_gap(WorldStream *world, int16_t x, int16_t y, Vector *center) {
+    const float size = world->config.chunk_size;
+    Bounds chunk = {.min={x * size, y * size}, .max={(x + 1) * size, (y + 1) * size}};
+    Bounds point = {.min=*center, .max=*center};
+    return bounds_distance(&chunk, &point);
+}
+
+WorldStream *world_stream_create(WorldStreamConfig config) {
+    WorldStream *world = allocate(sizeof(WorldStream));
+    check_pointer(world);
+    world->config = config;
+
+    //the most chunks within load_distance + hysteresis along one axis
+    const uint16_t span = (uint16_t) floorf(2 * (config.load_distance + config.hysteresis) / config.chunk_size) + 2;
+    world->capacity = span * span;
+    world->chunks = allocate(sizeof(WorldChunk) * world->capacity);
+    check_pointer(world->chunks);
+    for (uint16_t i = 0; i < world->capacity; i++) {
+        world->chunks[i].used = false;
+        world->chunks[i].node = NULL;
+    }
+    world->loaded = 0;
+
+    world->component = MAKE_COMPONENT();
+    world->component.update = &world_stream_update;
+    world->component.data = world;
+
+    world->root = allocate(sizeof(Node));
+    check_pointer(world->root);
+    *(world->root) = MAKE_NODE();
+    add_component(world->root, &(world->component));
+    return world;
+}
+
+void world_stream_release(WorldStream *world) {
+    release(world->chunks);
+    release(world);
+}
+
+static WorldChunk *find_chunk(WorldStream *world, int16_t x, int16_t y) {
+    for (uint16_t i = 0; i < world->capacity; i++) {
+        WorldChunk *chunk = &(world->chunks[i]);
+        if (chunk->used && chunk->x == x && chunk->y == y) return chunk;
+    }
+    return NULL;
+}
+
+Node *world_stream_chunk(WorldStream *world, int16_t x, int16_t y) {
+    WorldChunk *chunk = find_chunk(world, x, y);
+    return chunk ? chunk->node : NULL;
+}
+
+static void unload_far(WorldStream *world, Vector *center) {
+    const float limit = world->config.load_distance + world->config.hysteresis;
+    for (uint16_t i = 0; i < world->capacity && world->loaded > 0; i++) {
+        WorldChunk *chunk = &(world->chunks[i]);
+        if (!chunk->used || chunk_gap(world, chunk->x, chunk->y, center) <= limit) continue;
+        if (chunk->node) node_destroy(chunk->node);
+        chunk->node = NULL;
+        chunk->used = false;
+        world->loaded--;
+    }
+}
+
+// the missing chunk closest to the view center, false if every chunk in range is loaded
+static bool nearest_missing(WorldStream *world, Vector *center, int16_t *x, int16_t *y) {
+    const float size = world->config.chunk_size;
+    const float distance = world->config.load_distance;
+    float best = FLT_MAX;
+    for (int16_t cy = chunk_coordinate(center->y - distance, size); cy <= chunk_coordinate(center->y + distance, size); cy++) {
+        for (int16_t cx = chunk_coordinate(center->x - distance, size); cx <= chunk_coordinate(center->x + distance, size); cx++) {
+            float gap = chunk_gap(world, cx, cy, center);
+            if (gap > distance || gap >= best || find_chunk(world, cx, cy)) continue;
+            best = gap;
+            *x = cx;
+            *y = cy;
+        }
+    }
+    return best != FLT_MAX;
+}
+
+static bool load_chunk(WorldStream *world, int16_t x, int16_t y) {
+    WorldChunk *chunk = NULL;
+    for (uint16_t i = 0; i < world->capacity && !chunk; i++) {
+        if (!world->chunks[i].used) chunk = &(world->chunks[i]);
+    }
+    if (!chunk) {
+        FURI_LOG_W("WORLD", "No free chunk slot for %d,%d", x, y);
+        return false;
+    }
+
+    chunk->x = x;
+    chunk->y = y;
+    chunk->used = true;
+    chunk->node = world->config.load_chunk(x, y, world->config.context);
+    world->loaded++;
+    if (chunk->node) {
+        Vector origin = {x * world->config.chunk_size, y * world->config.chunk_size};
+        vector_add(&(chunk->node->transform.position), &origin, &(chunk->node->transform.position));
+        chunk->node->transform.dirty = true;
+        add_child(world->root, chunk->node);
+    }
+    return true;
+}
+
+// budget_us == 0 loads everything in range
+static void stream(WorldStream *world, uint16_t budget_us) {
+    Vector center = view_center();
+    unload_far(world, &center);
+
+    size_t start = curr_time();
+    int16_t x, y;
+    while (nearest_missing(world, &center, &x, &y)) {
+        if (!load_chunk(world, x, y)) break;
+        if (budget_us && (uint32_t) curr_time() - (uint32_t) start >= (uint32_t) budget_us * CYCLES_PER_US) break;
+    }
+}
+
+void world_stream_fill(WorldStream *world) {
+    stream(world, 0);
+}
+
+static void world_stream_update(Node *self, float delta, void *data) {
+    UNUSED(self);
+    UNUSED(delta);
+    WorldStream *world = data;
+    stream(world, world->config.budget_us ? world->config.budget_us : 1);
+}
+
+Node *world_stream_load_scene(int16_t x, int16_t y, void *context) {
+    WorldSceneSource *source = context;
+    char path[128];
+    snprintf(path, sizeof(path), source->path_format, x, y);
+    return scene_load(path, source->registry);
+}
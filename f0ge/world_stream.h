@@ -0,0 +1,64 @@
+#pragma once
+#include <furi.h>
+#include "node.h"
+#include "component.h"
+#include "scene.h"
+
+// Keeps the part of a large map around the camera in memory.
+// The world is a grid of square chunks, each chunk is a subtree made by load_chunk (eg. from a scene file).
+// Chunks closer to the view center than load_distance are loaded, nearest first, while the frame budget lasts.
+// Chunks further than load_distance + hysteresis are freed, so driving along a border does not reload them.
+
+typedef struct {
+    float chunk_size;           // world units, the subtree of a chunk is placed at (x * chunk_size, y * chunk_size)
+    float load_distance;        // gap between the view center and a chunk, should cover the movement of a few frames
+    float hysteresis;           // extra gap before a loaded chunk is freed
+    uint16_t budget_us;         // loading time per frame, one chunk is always started when one is missing
+    // returns the chunk subtree in chunk local coordinates, NULL for empty or missing chunks (not retried)
+    Node *(*load_chunk)(int16_t x, int16_t y, void *context);
+    void *context;
+} WorldStreamConfig;
+
+#define MAKE_WORLD_STREAM_CONFIG(size, loader) (WorldStreamConfig){ \
+    .chunk_size=size, \
+    .load_distance=size / 2, \
+    .hysteresis=size / 2, \
+    .budget_us=2000, \
+    .load_chunk=loader, \
+    .context=NULL \
+}
+
+typedef struct {
+    int16_t x;
+    int16_t y;
+    bool used;
+    Node *node;     // NULL for empty chunks
+} WorldChunk;
+
+typedef struct {
+    WorldStreamConfig config;
+    Node *root;             // add it to the scene, the chunks are its children
+    Component component;
+    WorldChunk *chunks;
+    uint16_t capacity;
+    uint16_t loaded;
+} WorldStream;
+
+WorldStream *world_stream_create(WorldStreamConfig config);
+
+// release it after cleanup_engine or node_destroy of its root
+void world_stream_release(WorldStream *world);
+
+// loads every chunk around the camera at once, ignoring the budget (eg. when the level starts)
+void world_stream_fill(WorldStream *world);
+
+// NULL if the chunk is not loaded or empty
+Node *world_stream_chunk(WorldStream *world, int16_t x, int16_t y);
+
+// adapter for load_chunk, context is a WorldSceneSource
+typedef struct {
+    const char *path_format;    // with two %d for the chunk coordinates, eg. EXT_PATH("apps_data/game/%d_%d.f0sc")
+    const SceneRegistry *registry;
+} WorldSceneSource;
+
+Node *world_stream_load_scene(int16_t x, int16_t y, void *context);
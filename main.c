@@ -153,6 +153,7 @@ int main() {
     //Start the engine
     init_engine((EngineConfig){
         .muted = false,
+        .volume = 100,
         .render_fps = 30,
         .backlight = true,
         .render_ui = NULL
@@ -0,0 +1,19 @@
+// Host run of the stress benchmark
+// usage: f0ge_stress [measured frames] [seed] > scaling.csv
+#include "bench/stress.h"
+
+static void write_line(const char *line, void *context) {
+    UNUSED(context);
+    fputs(line, stdout);
+    fflush(stdout);
+}
+
+int main(int argc, char **argv) {
+    StressConfig config = MAKE_STRESS_CONFIG(0);
+    config.headless = true;
+    if (argc > 1) config.measured_frames = (uint16_t) strtoul(argv[1], NULL, 10);
+    if (argc > 2) config.seed = (uint32_t) strtoul(argv[2], NULL, 10);
+
+    stress_curve(config, stress_default_steps, stress_default_step_count, write_line, NULL);
+    return 0;
+}
@@ -0,0 +1,246 @@
+#!/usr/bin/env python3
+"""Converts a bitmap font into the C source of a Font drawn by font_draw_text (f0ge/graphics/font.h).
+
+    python3 font_convert.py font_3x5.txt ../../f0ge/graphics/font_3x5.c
+    python3 font_convert.py --name font_6x10 --first 32 --last 126 6x10.bdf font_6x10.c
+
+Text input, '#' and '.' are the pixels of a glyph so comments start with '//':
+
+    name font_3x5
+    height 5                // line height is height + spacing
+    spacing 1               // default advance is width + spacing
+    uppercase_only yes
+    glyph A                 // a character, 'space' or a decimal code
+    .#.
+    #.#
+    ###
+    #.#
+    #.#
+    advance 4               // optional, right after the rows
+    kern A V -1
+
+Every glyph has height rows. BDF input uses the bounding boxes and DWIDTH of the glyphs.
+Empty rows at the top and the bottom of a glyph are not stored.
+"""
+import argparse
+import re
+import sys
+
+
+class FontError(Exception):
+    pass
+
+
+class Glyph:
+    def __init__(self, rows, width, x_offset=0, y_offset=0, advance=None):
+        self.rows = rows            # strings of '#' and '.', top to bottom
+        self.width = width
+        self.x_offset = x_offset
+        self.y_offset = y_offset
+        self.advance = advance
+
+
+class FontData:
+    def __init__(self):
+        self.name = None
+        self.height = 0
+        self.spacing = 1
+        self.uppercase_only = False
+        self.glyphs = {}
+        self.kerning = {}
+
+
+def parse_char(token):
+    if token == 'space':
+        return 32
+    if len(token) == 1:
+        return ord(token)
+    if token.isdigit():
+        return int(token)
+    raise FontError(f'unknown character {token}')
+
+
+def parse_text(lines):
+    font = FontData()
+    glyph = None
+    for number, line in enumerate(lines, 1):
+        words = line.split('//')[0].split()
+        if not words:
+            continue
+        try:
+            key = words[0]
+            if re.fullmatch(r'[#.]+', key) and glyph is not None:
+                glyph.rows.append(key)
+                if len(key) != glyph.width and glyph.width:
+                    raise FontError('rows of a glyph have to be equally wide')
+                glyph.width = len(key)
+                continue
+            glyph = None
+            if key == 'name':
+                font.name = words[1]
+            elif key == 'height':
+                font.height = int(words[1])
+            elif key == 'spacing':
+                font.spacing = int(words[1])
+            elif key == 'uppercase_only':
+                font.uppercase_only = words[1].lower() in ('1', 'yes', 'true')
+            elif key == 'glyph':
+                code = parse_char(words[1])
+                if code in font.glyphs:
+                    raise FontError(f'glyph {words[1]} is declared twice')
+                glyph = font.glyphs[code] = Glyph([], 0)
+            elif key == 'advance':
+                last = list(font.glyphs.values())[-1] if font.glyphs else None
+                if last is None:
+                    raise FontError('advance has to follow a glyph')
+                last.advance = int(words[1])
+            elif key == 'kern':
+                font.kerning[(parse_char(words[1]), parse_char(words[2]))] = int(words[3])
+            else:
+                raise FontError(f'unknown setting {key}')
+        except (IndexError, ValueError, FontError) as error:
+            raise FontError(f'line {number}: {error}') from None
+    for code, glyph in font.glyphs.items():
+        if len(glyph.rows) not in (0, font.height):
+            raise FontError(f'glyph {chr(code)!r} has {len(glyph.rows)} rows instead of {font.height}')
+        if glyph.advance is None:
+            glyph.advance = glyph.width + font.spacing
+    return font
+
+
+def parse_bdf(lines):
+    font = FontData()
+    ascent = 0
+    code = None
+    box = advance = None
+    rows = None
+    for line in lines:
+        words = line.split()
+        if not words:
+            continue
+        key = words[0]
+        if rows is not None:
+            if key == 'ENDCHAR':
+                width, height, x_off, y_off = box
+                bits = [bin(int(row, 16))[2:].zfill(len(row) * 4)[:width] for row in rows]
+                if code is not None and code >= 0:
+                    font.glyphs[code] = Glyph([row.replace('1', '#').replace('0', '.') for row in bits], width,
+                                              x_off, ascent - y_off - height, advance)
+                rows = None
+            else:
+                rows.append(key)
+        elif key == 'FONT_ASCENT':
+            ascent = int(words[1])
+        elif key == 'FONT_DESCENT':
+            font.height = ascent + int(words[1])
+        elif key == 'ENCODING':
+            code = int(words[1])
+        elif key == 'DWIDTH':
+            advance = int(words[1])
+        elif key == 'BBX':
+            box = tuple(int(word) for word in words[1:5])
+        elif key == 'BITMAP':
+            rows = []
+    if not font.glyphs:
+        raise FontError('no glyphs found')
+    return font
+
+
+def pack_row(row):
+    """Buffer layout, bit 0 is the leftmost pixel"""
+    out = bytearray((len(row) + 7) // 8)
+    for x, pixel in enumerate(row):
+        if pixel == '#':
+            out[x // 8] |= 1 << (x & 7)
+    return out
+
+
+def generate(font, first, last):
+    codes = [code for code in font.glyphs if first <= code <= last]
+    if not codes:
+        raise FontError('no glyphs in the selected range')
+    first, last = min(codes), max(codes)
+    glyphs, bitmaps = [], bytearray()
+    for code in range(first, last + 1):
+        glyph = font.glyphs.get(code)
+        if glyph is None:
+            glyphs.append((0, 0, 0, 0, 0, 0, code))
+            continue
+        rows = glyph.rows
+        top = 0
+        while top < len(rows) and '#' not in rows[top]:
+            top += 1
+        bottom = len(rows)
+        while bottom > top and '#' not in rows[bottom - 1]:
+            bottom -= 1
+        offset = len(bitmaps)
+        for row in rows[top:bottom]:
+            bitmaps += pack_row(row)
+        if offset > 0xFFFF:
+            raise FontError('the bitmaps are larger than 64 KiB')
+        glyphs.append((offset, glyph.width if bottom > top else 0, bottom - top, glyph.x_offset,
+                       glyph.y_offset + top if bottom > top else 0, glyph.advance, code))
+
+    kerning = sorted(((left << 8) | right, adjust) for (left, right), adjust in font.kerning.items() if adjust)
+
+    out = [f'// generated by tools/font/font_convert.py, do not edit', '#include "font.h"', '']
+    out.append(f'static const uint8_t {font.name}_bitmaps[] = {{')
+    for i in range(0, len(bitmaps), 12):
+        out.append('    ' + ', '.join(f'0x{byte:02X}' for byte in bitmaps[i:i + 12]) + ',')
+    out.append('};')
+    out.append('')
+    out.append(f'static const FontGlyph {font.name}_glyphs[] = {{')
+    for offset, width, height, x_offset, y_offset, advance, code in glyphs:
+        label = chr(code) if 32 < code < 127 and chr(code) not in '\\' else str(code)
+        out.append(f'    {{{offset}, {width}, {height}, {x_offset}, {y_offset}, {advance}}}, // {label}')
+    out.append('};')
+    out.append('')
+    if kerning:
+        out.append(f'static const FontKerning {font.name}_kerning[] = {{')
+        for pair, adjust in kerning:
+            out.append(f'    {{0x{pair:04X}, {adjust}}}, // {chr(pair >> 8)}{chr(pair & 0xFF)}')
+        out.append('};')
+        out.append('')
+    out.append(f'const Font {font.name} = {{')
+    out.append(f'    .height={font.height},')
+    out.append(f'    .line_height={font.height + font.spacing},')
+    out.append(f'    .first={first},')
+    out.append(f'    .last={last},')
+    out.append(f'    .uppercase_only={"true" if font.uppercase_only else "false"},')
+    out.append(f'    .glyphs={font.name}_glyphs,')
+    out.append(f'    .bitmaps={font.name}_bitmaps,')
+    out.append(f'    .kerning={font.name + "_kerning" if kerning else "NULL"},')
+    out.append(f'    .kerning_count={len(kerning)},')
+    out.append('};')
+    return '\n'.join(out) + '\n', len(bitmaps) + len(glyphs) * 7
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().split('\n\n')[0])
+    parser.add_argument('source')
+    parser.add_argument('target')
+    parser.add_argument('--name', help='C name of the font, overrides the name setting')
+    parser.add_argument('--first', type=int, default=32, help='first character to keep')
+    parser.add_argument('--last', type=int, default=126, help='last character to keep')
+    options = parser.parse_args()
+    try:
+        with open(options.source) as source:
+            lines = source.read().splitlines()
+        font = parse_bdf(lines) if options.source.endswith('.bdf') else parse_text(lines)
+        font.name = options.name or font.name
+        if not font.name or not re.fullmatch(r'[A-Za-z_]\w*', font.name):
+            raise FontError('the font needs a C name')
+        if not 0 < font.height < 256:
+            raise FontError('height has to be 1-255')
+        source, size = generate(font, options.first, options.last)
+    except FontError as error:
+        print(f'{options.source}: {error}', file=sys.stderr)
+        return 1
+    with open(options.target, 'w') as target:
+        target.write(source)
+    print(f'{options.target}: {len(font.glyphs)} glyphs, {size} bytes')
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
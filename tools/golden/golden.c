@@ -0,0 +1,537 @@
+// Golden frame regression harness
+// usage: f0ge_golden [--update] [golden dir] [output dir]
+// Renders the scripted cases below through the headless engine and compares every frame with the stored
+// hash (golden.txt) and image (<frame>.pbm). Mismatching frames are written to the output dir as
+// <frame>.actual.pbm and <frame>.diff.pbm (changed pixels are black). --update rewrites the goldens.
+// The F0GE_FIXED_POINT build (f0ge_golden_fixed) is checked against its own frames in frames_fixed.
+#include "f0ge/f0ge.h"
+#include "f0ge/graphics/render.h"
+#include "f0ge/graphics/mode7.h"
+#include "f0ge/graphics/draw.h"
+#include "f0ge/math/equation.h"
+#include "f0ge/utils/helpers.h"
+#include <sys/stat.h>
+
+#ifndef GOLDEN_DIR
+#define GOLDEN_DIR "tools/golden/frames"
+#endif
+
+#define MAX_FRAMES 512
+#define NAME_LENGTH 48
+#define MESH_VERTICES 38
+#define MESH_TRIANGLES 47
+
+typedef struct {
+    Buffer *sprite;
+    Buffer *mask;
+    RenderData sprite_render;
+    RenderData background_render;
+    Poly base_poly;
+    Node *root;
+    Node *node;
+    Node *background;
+    Buffer *floor;
+    Mode7 mode7;
+    bool clip;      // draw case, the shapes are drawn inside set_clip
+    Mesh mesh;
+    Vector mesh_vertices[MESH_VERTICES];
+    Vector mesh_uv[MESH_VERTICES];
+    uint8_t mesh_triangles[MESH_TRIANGLES * 3];
+} GoldenScene;
+
+typedef struct {
+    const char *name;
+    uint32_t frames;
+    // sets up the scene before the first frame, then poses it at the start of every frame
+    void (*setup)(GoldenScene *scene);
+    void (*pose)(GoldenScene *scene, uint32_t frame);
+} GoldenCase;
+
+typedef struct {
+    char name[NAME_LENGTH];
+    uint32_t hash;
+} GoldenEntry;
+
+static struct {
+    bool update;
+    const char *golden_dir;
+    const char *output_dir;
+    GoldenEntry entries[MAX_FRAMES];
+    uint32_t entry_count;
+    GoldenEntry rendered[MAX_FRAMES];
+    uint32_t rendered_count;
+    uint32_t failures;
+    const GoldenCase *current;
+    GoldenScene scene;
+} harness;
+
+// ---------------------------------------------------------------------------------------------------------------------
+// cases
+
+// an asymmetric glyph, any flip or rotation of it looks different
+static void draw_glyph(Buffer *b) {
+    buffer_fill_rect(b, 0, 0, 16, 1, COLOR_BLACK);
+    buffer_fill_rect(b, 0, 0, 1, 16, COLOR_BLACK);
+    buffer_fill_rect(b, 3, 3, 2, 10, COLOR_BLACK);
+    buffer_fill_rect(b, 3, 3, 9, 2, COLOR_BLACK);
+    buffer_fill_rect(b, 3, 7, 6, 2, COLOR_BLACK);
+    buffer_fill_rect(b, 12, 12, 3, 3, COLOR_BLACK);
+}
+
+static void setup_sprite(GoldenScene *scene, TileMode tile_mode) {
+    scene->sprite_render = (RenderData) {
+        .poly = RECTANGLE(-8, -8, 16, 16),
+        .tile_mode = tile_mode,
+        .color = COLOR_BLACK,
+        .mask_color = COLOR_WHITE,
+        .sprite = scene->sprite,
+    };
+    scene->base_poly = scene->sprite_render.poly;
+    node_set_sprite(scene->node, &(scene->sprite_render));
+    scene->node->transform.position = (Vector) {64, 32};
+    node_set_dirty(scene->node);
+}
+
+static void rotate_setup(GoldenScene *scene) {
+    setup_sprite(scene, TILE_NONE);
+    scene->node->transform.scale = (Vector) {2, 2};
+}
+
+static void rotate_pose(GoldenScene *scene, uint32_t frame) {
+    scene->node->transform.rotation = frame * 15.f;
+    node_set_dirty(scene->node);
+}
+
+static void scale_setup(GoldenScene *scene) {
+    setup_sprite(scene, TILE_NONE);
+}
+
+static void scale_pose(GoldenScene *scene, uint32_t frame) {
+    static const Vector scales[] = {
+        {0.5f, 0.5f}, {1, 1}, {1.5f, 1.5f}, {2, 2}, {3, 3}, {2, 0.5f}, {0.5f, 2}, {1.25f, 3.5f}
+    };
+    scene->node->transform.scale = scales[frame];
+    node_set_dirty(scene->node);
+}
+
+static void subpixel_setup(GoldenScene *scene) {
+    setup_sprite(scene, TILE_NONE);
+    scene->node->transform.scale = (Vector) {1.5f, 1.5f};
+}
+
+static void subpixel_pose(GoldenScene *scene, uint32_t frame) {
+    scene->node->transform.position = (Vector) {64 + frame / 8.f, 32 + frame / 16.f};
+    scene->node->transform.rotation = frame * 2.f;
+    node_set_dirty(scene->node);
+}
+
+// every TileMode with every FlipMode combination
+static void tile_flip_setup(GoldenScene *scene) {
+    setup_sprite(scene, TILE_NONE);
+    scene->node->transform.scale = (Vector) {3, 2};
+    scene->node->transform.rotation = 10;
+}
+
+static void tile_flip_pose(GoldenScene *scene, uint32_t frame) {
+    static const TileMode tiles[] = {TILE_NONE, TILE_HORIZONTAL, TILE_VERTICAL, TILE_BOTH};
+    scene->sprite_render.tile_mode = tiles[frame / 4];
+    scene->sprite_render.poly = scene->base_poly;
+    flip_uv(&(scene->sprite_render.poly), (FlipMode) (frame % 4));
+    set_renderer_dirty();
+}
+
+// masked sprite over a black background, the mask punches white around the glyph
+static void mask_setup(GoldenScene *scene) {
+    setup_sprite(scene, TILE_NONE);
+    scene->sprite_render.mask = scene->mask;
+    scene->node->transform.scale = (Vector) {2, 2};
+
+    scene->background_render = (RenderData) {
+        .poly = RECTANGLE(0, 0, 128, 64),
+        .tile_mode = TILE_NONE,
+        .color = COLOR_BLACK,
+    };
+    node_set_sprite(scene->background, &(scene->background_render));
+}
+
+static void mask_pose(GoldenScene *scene, uint32_t frame) {
+    static const float rotations[] = {0, 30, 45, 90, 135, 200};
+    scene->node->transform.rotation = rotations[frame];
+    scene->sprite_render.mask_color = frame & 1 ? COLOR_FLIP : COLOR_WHITE;
+    node_set_dirty(scene->node);
+}
+
+static void mode7_draw(Node *self, Buffer *buffer) {
+    UNUSED(self);
+    mode7_render_camera(buffer, &(harness.scene.mode7));
+}
+
+// perspective floor with a texture that is not a power of two wide, the camera crosses the negative coordinates
+static void mode7_setup(GoldenScene *scene) {
+    scene->floor = buffer_create(24, 16, false);
+    draw_glyph(scene->floor);
+    buffer_fill_rect(scene->floor, 16, 0, 1, 16, COLOR_BLACK);
+    buffer_fill_rect(scene->floor, 20, 4, 3, 8, COLOR_BLACK);
+    scene->mode7 = MAKE_MODE7(scene->floor);
+    mode7_prepare(&(scene->mode7));
+    scene->node->render_callback = mode7_draw;
+    node_set_sprite(scene->node, NULL);
+}
+
+static void mode7_pose(GoldenScene *scene, uint32_t frame) {
+    static const float rotations[] = {0, 0, 0, 0, 30, 90, 135, 180, 225, 270, 300, 350};
+    set_camera((Vector) {-64 - 20.f + frame * 3.5f, -32 - 10.f + frame * 1.75f});
+    set_camera_rotation(rotations[frame]);
+    scene->mode7.scale = frame < 4 ? 1 : 0.75f;
+    mode7_prepare(&(scene->mode7));
+    set_renderer_dirty();
+}
+
+// vector shapes in COLOR_FLIP over a half black background: pixels drawn twice (shared polygon edges, clipped
+// spans) show up as holes
+static void draw_shapes(Node *self, Buffer *buffer) {
+    UNUSED(self);
+    static const Vector fan[] = {{0, 0}, {18, 0}, {9, 15.6f}, {-9, 15.6f}, {-18, 0}, {-9, -15.6f}, {9, -15.6f}};
+    static const Vector quad[] = {{24, -20}, {44, -16}, {40, 6}, {22, 2}};
+    if (harness.scene.clip) set_clip(16, 8, 96, 48);
+    set_color(COLOR_FLIP);
+
+    // lines leaving the screen on both ends, one far outside it
+    Vector a = {-500, -310}, b = {600, 250};
+    draw_line(buffer, &a, &b);
+    a = (Vector) {-20, -400};
+    b = (Vector) {-20, 400};
+    draw_line(buffer, &a, &b);
+    a = (Vector) {-300, 200};
+    b = (Vector) {300, 220};
+    draw_line(buffer, &a, &b);
+
+    // circles and ellipses cut by the screen edges
+    Vector center = {-60, -28};
+    draw_circle(buffer, &center, 20, false);
+    center = (Vector) {-52, 26};
+    draw_circle(buffer, &center, 14, true);
+    center = (Vector) {58, 30};
+    draw_ellipse(buffer, &center, 24, 9, true);
+    center = (Vector) {60, -30};
+    draw_ellipse(buffer, &center, 10, 18, false);
+
+    // triangles of a fan and the two halves of a quad share their edges
+    for (uint8_t i = 1; i < 7; i++) {
+        const Vector triangle[] = {fan[0], fan[i], fan[i % 6 + 1]};
+        draw_polygon(buffer, triangle, 3, true);
+    }
+    const Vector first[] = {quad[0], quad[1], quad[2]};
+    const Vector second[] = {quad[0], quad[2], quad[3]};
+    draw_polygon(buffer, first, 3, true);
+    draw_polygon(buffer, second, 3, true);
+
+    set_color(COLOR_BLACK);
+    reset_clip();
+}
+
+static void draw_setup(GoldenScene *scene) {
+    scene->background_render = (RenderData) {
+        .poly = RECTANGLE(0, 0, 64, 64),
+        .tile_mode = TILE_NONE,
+        .color = COLOR_BLACK,
+    };
+    node_set_sprite(scene->background, &(scene->background_render));
+    scene->node->render_callback = draw_shapes;
+    node_set_sprite(scene->node, NULL);
+}
+
+static void draw_pose(GoldenScene *scene, uint32_t frame) {
+    scene->node->transform.position = (Vector) {64 + frame * 1.3f, 32 - frame * 0.7f};
+    scene->node->transform.rotation = frame * 13.f;
+    scene->node->transform.scale = frame & 1 ? (Vector) {1.25f, 0.8f} : (Vector) {1, 1};
+    scene->clip = frame >= 6;
+    node_set_dirty(scene->node);
+}
+
+// A 5x4 grid of quads and a fan of 7 triangles in COLOR_FLIP, the triangles share their edges. At the first pose
+// every vertex is on a pixel center, a pixel drawn by two triangles shows up as a hole.
+static void mesh_setup(GoldenScene *scene) {
+    uint8_t *triangles = scene->mesh_triangles;
+    for (uint8_t y = 0; y < 5; y++) {
+        for (uint8_t x = 0; x < 6; x++) {
+            scene->mesh_vertices[y * 6 + x] = (Vector) {-56 + x * 8, -16 + y * 8};
+            scene->mesh_uv[y * 6 + x] = (Vector) {x / 5.f, y / 4.f};
+        }
+    }
+    for (uint8_t y = 0; y < 4; y++) {
+        for (uint8_t x = 0; x < 5; x++) {
+            const uint8_t a = y * 6 + x;
+            //the diagonals alternate, so edges run both ways
+            const uint8_t quad[6] = {a, a + 1, a + 7, a, a + 7, a + 6};
+            const uint8_t flipped[6] = {a, a + 1, a + 6, a + 1, a + 7, a + 6};
+            memcpy(triangles, (x + y) & 1 ? flipped : quad, sizeof(quad));
+            triangles += 6;
+        }
+    }
+    const uint8_t center = 30;
+    scene->mesh_vertices[center] = (Vector) {30, 0};
+    scene->mesh_uv[center] = (Vector) {0.5f, 0.5f};
+    for (uint8_t i = 0; i < 7; i++) {
+        const float angle = i * M_PIX2 / 7;
+        scene->mesh_vertices[center + 1 + i] = (Vector) {roundf(30 + 20 * cosf(angle)), roundf(18 * sinf(angle))};
+        scene->mesh_uv[center + 1 + i] = (Vector) {0.5f + 0.5f * cosf(angle), 0.5f + 0.5f * sinf(angle)};
+        triangles[0] = center;
+        triangles[1] = center + 1 + i;
+        triangles[2] = center + 1 + (i + 1) % 7;
+        triangles += 3;
+    }
+    scene->mesh = MAKE_MESH(scene->mesh_vertices, scene->mesh_uv, scene->mesh_triangles, MESH_VERTICES,
+                            MESH_TRIANGLES);
+
+    scene->sprite_render = (RenderData) {
+        .poly = RECTANGLE(-56, -20, 106, 40),
+        .mesh = &(scene->mesh),
+        .tile_mode = TILE_NONE,
+        .color = COLOR_FLIP,
+        .sprite = scene->sprite,
+    };
+    node_set_sprite(scene->node, &(scene->sprite_render));
+
+    scene->background_render = (RenderData) {
+        .poly = RECTANGLE(0, 0, 64, 64),
+        .tile_mode = TILE_NONE,
+        .color = COLOR_BLACK,
+    };
+    node_set_sprite(scene->background, &(scene->background_render));
+}
+
+// solid first (the mask is all black), then the glyph
+static void mesh_pose(GoldenScene *scene, uint32_t frame) {
+    static const Vector positions[] = {{64.5f, 32.5f}, {64.25f, 32.75f}, {64.5f, 32.5f}, {63.9f, 31.3f}};
+    static const float rotations[] = {0, 0, 90, 33};
+    scene->node->transform.position = positions[frame % 4];
+    scene->node->transform.rotation = rotations[frame % 4];
+    scene->node->transform.scale = frame % 4 == 3 ? (Vector) {1.3f, 0.9f} : (Vector) {1, 1};
+    scene->sprite_render.sprite = frame < 4 ? scene->mask : scene->sprite;
+    set_renderer_dirty();
+    node_set_dirty(scene->node);
+}
+
+static const GoldenCase cases[] = {
+    {"rotate", 24, rotate_setup, rotate_pose},
+    {"scale", 8, scale_setup, scale_pose},
+    {"subpixel", 16, subpixel_setup, subpixel_pose},
+    {"tile_flip", 16, tile_flip_setup, tile_flip_pose},
+    {"mask", 6, mask_setup, mask_pose},
+    {"mode7", 12, mode7_setup, mode7_pose},
+    {"draw", 8, draw_setup, draw_pose},
+    {"mesh", 8, mesh_setup, mesh_pose},
+};
+
+// ---------------------------------------------------------------------------------------------------------------------
+// pbm files, 1 is black, the leftmost pixel is the highest bit
+
+static bool write_pbm(const char *path, Buffer *buffer) {
+    FILE *f = fopen(path, "wb");
+    if (!f) return false;
+    fprintf(f, "P4\n%d %d\n", buffer->width, buffer->height);
+    for (int y = 0; y < buffer->height; y++) {
+        for (int x = 0; x < buffer->width; x += 8) {
+            uint8_t byte = 0;
+            for (int bit = 0; bit < 8 && x + bit < buffer->width; bit++) {
+                if (buffer_read_pixel(buffer, x + bit, y)) byte |= 0x80 >> bit;
+            }
+            fputc(byte, f);
+        }
+    }
+    fclose(f);
+    return true;
+}
+
+static Buffer *read_pbm(const char *path) {
+    FILE *f = fopen(path, "rb");
+    if (!f) return NULL;
+    int width, height;
+    if (fscanf(f, "P4 %d %d", &width, &height) != 2 || fgetc(f) == EOF || width > 255 || height > 255) {
+        fclose(f);
+        return NULL;
+    }
+    Buffer *buffer = buffer_create(width, height, false);
+    buffer_fill(buffer, COLOR_WHITE);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x += 8) {
+            int byte = fgetc(f);
+            for (int bit = 0; bit < 8 && x + bit < width; bit++) {
+                if (byte & (0x80 >> bit)) buffer_set_pixel(buffer, x + bit, y, COLOR_BLACK);
+            }
+        }
+    }
+    fclose(f);
+    return buffer;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+// golden.txt, one "<frame> <hash>" line per frame
+
+static void load_manifest() {
+    char path[256];
+    snprintf(path, sizeof(path), "%s/golden.txt", harness.golden_dir);
+    FILE *f = fopen(path, "r");
+    if (!f) return;
+    GoldenEntry *e = harness.entries;
+    while (harness.entry_count < MAX_FRAMES && fscanf(f, "%47s %x", e->name, &(e->hash)) == 2) {
+        harness.entry_count++;
+        e++;
+    }
+    fclose(f);
+}
+
+static void save_manifest() {
+    char path[256];
+    snprintf(path, sizeof(path), "%s/golden.txt", harness.golden_dir);
+    FILE *f = fopen(path, "w");
+    if (!f) {
+        FURI_LOG_E("GOLDEN", "Cannot write %s", path);
+        return;
+    }
+    for (uint32_t i = 0; i < harness.rendered_count; i++) {
+        fprintf(f, "%s %08x\n", harness.rendered[i].name, harness.rendered[i].hash);
+    }
+    fclose(f);
+}
+
+static GoldenEntry *find_golden(const char *name) {
+    for (uint32_t i = 0; i < harness.entry_count; i++) {
+        if (strcmp(harness.entries[i].name, name) == 0) return &(harness.entries[i]);
+    }
+    return NULL;
+}
+
+// ---------------------------------------------------------------------------------------------------------------------
+
+static void dump_mismatch(const char *name, Buffer *actual, Buffer *golden) {
+    char path[256];
+    snprintf(path, sizeof(path), "%s/%s.actual.pbm", harness.output_dir, name);
+    write_pbm(path, actual);
+    if (!golden) return;
+
+    Buffer *diff = buffer_create(actual->width, actual->height, false);
+    buffer_fill(diff, COLOR_WHITE);
+    uint32_t changed = 0;
+    for (int y = 0; y < actual->height; y++) {
+        for (int x = 0; x < actual->width; x++) {
+            if (buffer_read_pixel(actual, x, y) != buffer_read_pixel(golden, x, y)) {
+                buffer_set_pixel(diff, x, y, COLOR_BLACK);
+                changed++;
+            }
+        }
+    }
+    snprintf(path, sizeof(path), "%s/%s.diff.pbm", harness.output_dir, name);
+    write_pbm(path, diff);
+    buffer_release(diff);
+    printf("  %lu pixels changed\n", (unsigned long) changed);
+}
+
+static void check_frame(const char *name, Buffer *buffer) {
+    const uint32_t hash = buffer_checksum(buffer);
+    char path[256];
+    snprintf(path, sizeof(path), "%s/%s.pbm", harness.golden_dir, name);
+
+    if (harness.update) {
+        write_pbm(path, buffer);
+        return;
+    }
+
+    GoldenEntry *entry = find_golden(name);
+    if (entry && entry->hash == hash) return;
+
+    Buffer *golden = read_pbm(path);
+    bool same_image = golden && golden->width == buffer->width && golden->height == buffer->height &&
+                      buffer_checksum(golden) == hash;
+    if (same_image) {
+        // only the manifest is stale
+        buffer_release(golden);
+        return;
+    }
+
+    harness.failures++;
+    printf("FAIL %s: %08x, golden %08x%s\n", name, hash, entry ? entry->hash : 0, entry ? "" : " (missing)");
+    dump_mismatch(name, buffer, golden);
+    if (golden) buffer_release(golden);
+}
+
+static void on_frame_start(void *gameState, uint32_t frame) {
+    harness.current->pose(gameState, frame);
+}
+
+static void on_frame_end(void *gameState, uint32_t frame, Buffer *buffer) {
+    UNUSED(gameState);
+    GoldenEntry *entry = &(harness.rendered[harness.rendered_count++]);
+    snprintf(entry->name, NAME_LENGTH, "%s_%03lu", harness.current->name, (unsigned long) frame);
+    entry->hash = buffer_checksum(buffer);
+    check_frame(entry->name, buffer);
+
+    if (frame + 1 >= harness.current->frames) engine_exit();
+}
+
+static void run_case(const GoldenCase *golden_case) {
+    EngineContext *context = engine_context_create();
+    engine_context_bind(context);
+    harness.current = golden_case;
+
+    GoldenScene *scene = &(harness.scene);
+    memset(scene, 0, sizeof(GoldenScene));
+    scene->sprite = buffer_create(16, 16, false);
+    draw_glyph(scene->sprite);
+    scene->mask = buffer_create(16, 16, false);
+    buffer_fill_rect(scene->mask, 0, 0, 16, 16, COLOR_BLACK);
+
+    scene->root = allocate(sizeof(Node));
+    scene->background = allocate(sizeof(Node));
+    scene->node = allocate(sizeof(Node));
+    *(scene->root) = MAKE_NODE();
+    *(scene->background) = MAKE_NODE();
+    *(scene->node) = MAKE_NODE();
+    add_child(scene->root, scene->background);
+    add_child(scene->root, scene->node);
+
+    init_engine((EngineConfig) {
+        .render_fps = 30,
+        .headless = true,
+        .gameState = scene,
+        .on_frame_start = on_frame_start,
+        .on_frame_end = on_frame_end,
+    });
+    set_scene(scene->root);
+    golden_case->setup(scene);
+    start_loop();
+
+    buffer_release(scene->sprite);
+    buffer_release(scene->mask);
+    if (scene->floor) buffer_release(scene->floor);
+    engine_context_bind(NULL);
+    engine_context_release(context);
+}
+
+int main(int argc, char **argv) {
+    harness.golden_dir = GOLDEN_DIR;
+    harness.output_dir = "golden_out";
+    uint8_t positional = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--update") == 0) harness.update = true;
+        else if (positional++ == 0) harness.golden_dir = argv[i];
+        else harness.output_dir = argv[i];
+    }
+
+    load_manifest();
+    mkdir(harness.output_dir, 0755);
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        run_case(&cases[i]);
+    }
+
+    if (harness.update) {
+        save_manifest();
+        printf("%lu golden frames written to %s\n", (unsigned long) harness.rendered_count, harness.golden_dir);
+        return 0;
+    }
+
+    printf("%lu frames, %lu failures\n", (unsigned long) harness.rendered_count, (unsigned long) harness.failures);
+    return harness.failures ? 1 : 0;
+}
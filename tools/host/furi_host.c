@@ -0,0 +1,396 @@
+// Desktop implementation of the furi calls used by the engine (F0GE_HOST)
+// gui and input are inert, headless engine runs never touch them, notifications only play the sound and the vibro
+#define _GNU_SOURCE
+#include <furi.h>
+#include <gui/gui.h>
+#include <notification/notification_messages.h>
+#include <toolbox/compress.h>
+#include <storage/storage.h>
+#include <furi_hal.h>
+#include <pthread.h>
+#include <sched.h>
+#include <errno.h>
+#include <time.h>
+#include <sys/stat.h>
+
+static DWT_Type dwt;
+DWT_Type *DWT = &dwt;
+
+static uint64_t now_ms() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000u + (uint64_t) ts.tv_nsec / 1000000u;
+}
+
+static void deadline_after(struct timespec *ts, uint32_t ms) {
+    clock_gettime(CLOCK_REALTIME, ts);
+    ts->tv_sec += ms / 1000;
+    ts->tv_nsec += (long) (ms % 1000) * 1000000L;
+    if (ts->tv_nsec >= 1000000000L) {
+        ts->tv_sec++;
+        ts->tv_nsec -= 1000000000L;
+    }
+}
+
+uint32_t furi_get_tick(void) {
+    return (uint32_t) now_ms();
+}
+
+uint32_t furi_ms_to_ticks(uint32_t ms) {
+    return ms;
+}
+
+uint32_t furi_kernel_get_tick_frequency(void) {
+    return 1000;
+}
+
+void furi_delay_ms(uint32_t ms) {
+    struct timespec ts = {.tv_sec = ms / 1000, .tv_nsec = (long) (ms % 1000) * 1000000L};
+    while (nanosleep(&ts, &ts) == -1 && errno == EINTR);
+}
+
+struct FuriMutex {
+    pthread_mutex_t mutex;
+};
+
+FuriMutex *furi_mutex_alloc(FuriMutexType type) {
+    FuriMutex *m = malloc(sizeof(FuriMutex));
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, type == FuriMutexTypeRecursive ? PTHREAD_MUTEX_RECURSIVE : PTHREAD_MUTEX_NORMAL);
+    pthread_mutex_init(&m->mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+    return m;
+}
+
+void furi_mutex_free(FuriMutex *mutex) {
+    pthread_mutex_destroy(&mutex->mutex);
+    free(mutex);
+}
+
+FuriStatus furi_mutex_acquire(FuriMutex *mutex, uint32_t timeout) {
+    if (timeout == FuriWaitForever) {
+        return pthread_mutex_lock(&mutex->mutex) == 0 ? FuriStatusOk : FuriStatusError;
+    }
+    struct timespec deadline;
+    deadline_after(&deadline, timeout);
+    int r = pthread_mutex_timedlock(&mutex->mutex, &deadline);
+    if (r == ETIMEDOUT) return FuriStatusErrorTimeout;
+    return r == 0 ? FuriStatusOk : FuriStatusError;
+}
+
+FuriStatus furi_mutex_release(FuriMutex *mutex) {
+    return pthread_mutex_unlock(&mutex->mutex) == 0 ? FuriStatusOk : FuriStatusError;
+}
+
+void furi_thread_set_current_priority(FuriThreadPriority priority) {
+    UNUSED(priority);
+}
+
+void furi_thread_yield(void) {
+    sched_yield();
+}
+
+// every running timer owns a thread that waits on a condition until the period elapses or it is stopped
+struct FuriTimer {
+    FuriTimerCallback callback;
+    FuriTimerType type;
+    void *context;
+    uint32_t period;
+    bool running;
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+};
+
+static void *timer_thread(void *arg) {
+    FuriTimer *timer = arg;
+    pthread_mutex_lock(&timer->lock);
+    while (timer->running) {
+        struct timespec deadline;
+        deadline_after(&deadline, timer->period);
+        int r = 0;
+        while (timer->running && r != ETIMEDOUT) {
+            r = pthread_cond_timedwait(&timer->wake, &timer->lock, &deadline);
+        }
+        if (!timer->running) break;
+
+        pthread_mutex_unlock(&timer->lock);
+        timer->callback(timer->context);
+        pthread_mutex_lock(&timer->lock);
+
+        if (timer->type == FuriTimerTypeOnce) timer->running = false;
+    }
+    pthread_mutex_unlock(&timer->lock);
+    return NULL;
+}
+
+FuriTimer *furi_timer_alloc(FuriTimerCallback callback, FuriTimerType type, void *context) {
+    FuriTimer *timer = calloc(1, sizeof(FuriTimer));
+    timer->callback = callback;
+    timer->type = type;
+    timer->context = context;
+    pthread_mutex_init(&timer->lock, NULL);
+    pthread_cond_init(&timer->wake, NULL);
+    return timer;
+}
+
+FuriStatus furi_timer_stop(FuriTimer *timer) {
+    pthread_mutex_lock(&timer->lock);
+    bool had_thread = timer->thread != 0;
+    timer->running = false;
+    pthread_cond_signal(&timer->wake);
+    pthread_mutex_unlock(&timer->lock);
+    if (had_thread) {
+        // stopping from the callback cannot wait for its own thread
+        if (pthread_equal(timer->thread, pthread_self())) pthread_detach(timer->thread);
+        else pthread_join(timer->thread, NULL);
+        timer->thread = 0;
+    }
+    return FuriStatusOk;
+}
+
+FuriStatus furi_timer_start(FuriTimer *timer, uint32_t ticks) {
+    furi_timer_stop(timer);
+    timer->period = ticks;
+    timer->running = true;
+    if (pthread_create(&timer->thread, NULL, timer_thread, timer) != 0) {
+        timer->running = false;
+        timer->thread = 0;
+        return FuriStatusError;
+    }
+    return FuriStatusOk;
+}
+
+void furi_timer_free(FuriTimer *timer) {
+    furi_timer_stop(timer);
+    pthread_cond_destroy(&timer->wake);
+    pthread_mutex_destroy(&timer->lock);
+    free(timer);
+}
+
+FuriPubSubSubscription *furi_pubsub_subscribe(FuriPubSub *pubsub, FuriPubSubCallback callback, void *context) {
+    UNUSED(pubsub);
+    UNUSED(callback);
+    UNUSED(context);
+    return NULL;
+}
+
+void furi_pubsub_unsubscribe(FuriPubSub *pubsub, FuriPubSubSubscription *subscription) {
+    UNUSED(pubsub);
+    UNUSED(subscription);
+}
+
+// storage and notification are the only records with a host implementation, their handles are never dereferenced
+static char storage_record;
+static char notification_record;
+
+void *furi_record_open(const char *name) {
+    if (strcmp(name, RECORD_STORAGE) == 0) return &storage_record;
+    if (strcmp(name, RECORD_NOTIFICATION) == 0) return &notification_record;
+    return NULL;
+}
+
+void furi_record_close(const char *name) {
+    UNUSED(name);
+}
+
+// the host heap is treated as plentiful
+size_t memmgr_get_free_heap(void) {
+    return 1u << 30;
+}
+
+size_t memmgr_get_total_heap(void) {
+    return 1u << 30;
+}
+
+FuriHalHostSound furi_hal_host_sound;
+
+void canvas_draw_xbm(Canvas *canvas, int32_t x, int32_t y, size_t width, size_t height, const uint8_t *bitmap) {
+    UNUSED(canvas);
+    UNUSED(x);
+    UNUSED(y);
+    UNUSED(width);
+    UNUSED(height);
+    UNUSED(bitmap);
+}
+
+void canvas_commit(Canvas *canvas) {
+    UNUSED(canvas);
+}
+
+Canvas *gui_direct_draw_acquire(Gui *gui) {
+    UNUSED(gui);
+    return NULL;
+}
+
+void gui_direct_draw_release(Gui *gui) {
+    UNUSED(gui);
+}
+
+const NotificationSequence sequence_display_backlight_enforce_on = {NULL};
+const NotificationSequence sequence_display_backlight_enforce_auto = {NULL};
+
+static const NotificationMessage message_sound_off = {.type=NotificationMessageTypeSoundOff};
+static const NotificationMessage message_vibro_on = {.type=NotificationMessageTypeVibro, .data.vibro={.on=true}};
+static const NotificationMessage message_vibro_off = {.type=NotificationMessageTypeVibro, .data.vibro={.on=false}};
+const NotificationMessage message_do_not_reset = {.type=NotificationMessageTypeDoNotReset};
+
+const NotificationSequence sequence_reset_sound = {&message_sound_off, NULL};
+const NotificationSequence sequence_set_vibro_on = {&message_vibro_on, &message_do_not_reset, NULL};
+const NotificationSequence sequence_reset_vibro = {&message_vibro_off, NULL};
+
+NotificationHostSettings notification_host_settings = {.speaker_volume=1.0f, .vibro_on=true, .stealth=false};
+static pthread_mutex_t notification_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// like the service, the sound and the vibro are reset after the sequence unless it asks not to
+void notification_message(NotificationApp *app, const NotificationSequence *sequence) {
+    UNUSED(app);
+    const NotificationHostSettings *settings = &notification_host_settings;
+    bool sound = false, vibro = false, reset = true;
+    pthread_mutex_lock(&notification_lock);
+    for (const NotificationMessage *const *message = *sequence; *message; message++) {
+        switch ((*message)->type) {
+            case NotificationMessageTypeSoundOn:
+                if (settings->stealth) break;
+                furi_hal_host_sound.speaker_starts++;
+                furi_hal_host_sound.frequency = (*message)->data.sound.frequency;
+                furi_hal_host_sound.volume = (*message)->data.sound.volume * settings->speaker_volume;
+                sound = true;
+                break;
+            case NotificationMessageTypeSoundOff:
+                furi_hal_host_sound.frequency = 0;
+                break;
+            case NotificationMessageTypeVibro:
+                if ((*message)->data.vibro.on && !settings->vibro_on) break;
+                if ((*message)->data.vibro.on && !furi_hal_host_sound.vibro) furi_hal_host_sound.vibro_starts++;
+                furi_hal_host_sound.vibro = (*message)->data.vibro.on;
+                vibro = (*message)->data.vibro.on;
+                break;
+            case NotificationMessageTypeDoNotReset:
+                reset = false;
+                break;
+            default:
+                break;
+        }
+    }
+    if (reset && sound) furi_hal_host_sound.frequency = 0;
+    if (reset && vibro) furi_hal_host_sound.vibro = false;
+    pthread_mutex_unlock(&notification_lock);
+}
+
+void notification_message_block(NotificationApp *app, const NotificationSequence *sequence) {
+    notification_message(app, sequence);
+}
+
+uint16_t icon_get_width(const Icon *icon) {
+    return icon->width;
+}
+
+uint16_t icon_get_height(const Icon *icon) {
+    return icon->height;
+}
+
+const uint8_t *icon_get_frame_data(const Icon *icon, uint32_t frame) {
+    return icon->frames[frame];
+}
+
+struct CompressIcon {
+    size_t size;
+    uint8_t data[];
+};
+
+CompressIcon *compress_icon_alloc(size_t decode_buf_size) {
+    CompressIcon *instance = calloc(1, sizeof(CompressIcon) + decode_buf_size);
+    instance->size = decode_buf_size;
+    return instance;
+}
+
+void compress_icon_free(CompressIcon *instance) {
+    free(instance);
+}
+
+void compress_icon_decode(CompressIcon *instance, const uint8_t *icon_data, uint8_t **output) {
+    if (icon_data[0] == 0) {
+        *output = (uint8_t *) (icon_data + 1);
+        return;
+    }
+    FURI_LOG_E("HOST", "compressed icons are not supported");
+    memset(instance->data, 0, instance->size);
+    *output = instance->data;
+}
+
+struct File {
+    FILE *stream;
+};
+
+static const char *host_path(const char *path) {
+    if (strncmp(path, "/ext/", 5) == 0) return path + 5;
+    return path;
+}
+
+File *storage_file_alloc(Storage *storage) {
+    UNUSED(storage);
+    return calloc(1, sizeof(File));
+}
+
+void storage_file_free(File *file) {
+    if (file->stream) fclose(file->stream);
+    free(file);
+}
+
+bool storage_file_open(File *file, const char *path, FS_AccessMode access_mode, FS_OpenMode open_mode) {
+    const char *mode;
+    if (open_mode & FSOM_CREATE_ALWAYS) mode = access_mode & FSAM_READ ? "w+b" : "wb";
+    else if (open_mode & FSOM_OPEN_APPEND) mode = access_mode & FSAM_READ ? "a+b" : "ab";
+    else mode = access_mode & FSAM_WRITE ? "r+b" : "rb";
+
+    file->stream = fopen(host_path(path), mode);
+    if (!file->stream && (open_mode & (FSOM_OPEN_ALWAYS | FSOM_CREATE_NEW))) {
+        file->stream = fopen(host_path(path), access_mode & FSAM_READ ? "w+b" : "wb");
+    }
+    return file->stream != NULL;
+}
+
+bool storage_file_close(File *file) {
+    if (!file->stream) return false;
+    fclose(file->stream);
+    file->stream = NULL;
+    return true;
+}
+
+size_t storage_file_read(File *file, void *buff, size_t bytes_to_read) {
+    return fread(buff, 1, bytes_to_read, file->stream);
+}
+
+size_t storage_file_write(File *file, const void *buff, size_t bytes_to_write) {
+    return fwrite(buff, 1, bytes_to_write, file->stream);
+}
+
+bool storage_file_seek(File *file, uint32_t offset, bool from_start) {
+    return fseek(file->stream, offset, from_start ? SEEK_SET : SEEK_CUR) == 0;
+}
+
+uint64_t storage_file_tell(File *file) {
+    return (uint64_t) ftell(file->stream);
+}
+
+uint64_t storage_file_size(File *file) {
+    long position = ftell(file->stream);
+    fseek(file->stream, 0, SEEK_END);
+    long size = ftell(file->stream);
+    fseek(file->stream, position, SEEK_SET);
+    return (uint64_t) size;
+}
+
+bool storage_file_eof(File *file) {
+    int c = fgetc(file->stream);
+    if (c == EOF) return true;
+    ungetc(c, file->stream);
+    return false;
+}
+
+bool storage_simply_mkdir(Storage *storage, const char *path) {
+    UNUSED(storage);
+    return mkdir(host_path(path), 0755) == 0 || errno == EEXIST;
+}
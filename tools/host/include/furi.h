@@ -0,0 +1,99 @@
+#pragma once
+// Minimal furi api for building the engine on a desktop (F0GE_HOST), see tools/host/furi_host.c
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <math.h>
+
+#ifndef F0GE_HOST
+#error "tools/host is only meant for host builds, define F0GE_HOST"
+#endif
+
+#define UNUSED(x) (void) (x)
+#ifndef MIN
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#endif
+#ifndef MAX
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+#endif
+
+// debug logs are very chatty (every allocation), they are opt in on the host
+#ifdef F0GE_HOST_LOG_DEBUG
+#define FURI_LOG_D(tag, format, ...) fprintf(stderr, "[D][%s] " format "\n", tag, ##__VA_ARGS__)
+#else
+#define FURI_LOG_D(tag, format, ...) ((void) 0)
+#endif
+#define FURI_LOG_I(tag, format, ...) fprintf(stderr, "[I][%s] " format "\n", tag, ##__VA_ARGS__)
+#define FURI_LOG_W(tag, format, ...) fprintf(stderr, "[W][%s] " format "\n", tag, ##__VA_ARGS__)
+#define FURI_LOG_E(tag, format, ...) fprintf(stderr, "[E][%s] " format "\n", tag, ##__VA_ARGS__)
+
+#define furi_assert(x) ((void) 0)
+#define furi_check(x) do { if (!(x)) abort(); } while (0)
+
+typedef enum {
+    FuriStatusOk = 0,
+    FuriStatusError = -1,
+    FuriStatusErrorTimeout = -2,
+} FuriStatus;
+
+#define FuriWaitForever 0xFFFFFFFFU
+
+typedef enum {
+    FuriMutexTypeNormal,
+    FuriMutexTypeRecursive,
+} FuriMutexType;
+
+typedef enum {
+    FuriThreadPriorityIdle = 1,
+    FuriThreadPriorityNormal = 16,
+} FuriThreadPriority;
+
+typedef enum {
+    FuriTimerTypeOnce,
+    FuriTimerTypePeriodic,
+} FuriTimerType;
+
+typedef struct FuriMutex FuriMutex;
+typedef struct FuriPubSub FuriPubSub;
+typedef struct FuriPubSubSubscription FuriPubSubSubscription;
+typedef struct FuriTimer FuriTimer;
+typedef void (*FuriPubSubCallback)(const void *message, void *context);
+typedef void (*FuriTimerCallback)(void *context);
+
+uint32_t furi_get_tick(void);
+uint32_t furi_ms_to_ticks(uint32_t ms);
+uint32_t furi_kernel_get_tick_frequency(void);
+void furi_delay_ms(uint32_t ms);
+
+FuriMutex *furi_mutex_alloc(FuriMutexType type);
+void furi_mutex_free(FuriMutex *mutex);
+FuriStatus furi_mutex_acquire(FuriMutex *mutex, uint32_t timeout);
+FuriStatus furi_mutex_release(FuriMutex *mutex);
+
+void furi_thread_set_current_priority(FuriThreadPriority priority);
+void furi_thread_yield(void);
+
+FuriTimer *furi_timer_alloc(FuriTimerCallback callback, FuriTimerType type, void *context);
+void furi_timer_free(FuriTimer *timer);
+FuriStatus furi_timer_start(FuriTimer *timer, uint32_t ticks);
+FuriStatus furi_timer_stop(FuriTimer *timer);
+
+FuriPubSubSubscription *furi_pubsub_subscribe(FuriPubSub *pubsub, FuriPubSubCallback callback, void *context);
+void furi_pubsub_unsubscribe(FuriPubSub *pubsub, FuriPubSubSubscription *subscription);
+
+// records do not exist on the host, the engine only opens them outside of headless mode
+void *furi_record_open(const char *name);
+void furi_record_close(const char *name);
+
+size_t memmgr_get_free_heap(void);
+size_t memmgr_get_total_heap(void);
+
+// cycle counter, it does not run on the host
+typedef struct {
+    volatile uint32_t CYCCNT;
+} DWT_Type;
+extern DWT_Type *DWT;
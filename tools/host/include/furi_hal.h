@@ -0,0 +1,14 @@
+#pragma once
+#include <furi.h>
+
+// there is no speaker or vibro motor on the host, what the notification service would play is recorded for tests
+// and benchmarks
+typedef struct {
+    uint32_t speaker_starts;
+    uint32_t vibro_starts;
+    float frequency;    // of the sound playing, 0 when silent
+    float volume;
+    bool vibro;
+} FuriHalHostSound;
+
+extern FuriHalHostSound furi_hal_host_sound;
@@ -0,0 +1,8 @@
+#pragma once
+#include <furi.h>
+#include <gui/icon.h>
+
+typedef struct Canvas Canvas;
+
+void canvas_draw_xbm(Canvas *canvas, int32_t x, int32_t y, size_t width, size_t height, const uint8_t *bitmap);
+void canvas_commit(Canvas *canvas);
@@ -0,0 +1,10 @@
+#pragma once
+#include <gui/canvas.h>
+#include <input/input.h>
+
+#define RECORD_GUI "gui"
+
+typedef struct Gui Gui;
+
+Canvas *gui_direct_draw_acquire(Gui *gui);
+void gui_direct_draw_release(Gui *gui);
@@ -0,0 +1,15 @@
+#pragma once
+#include <furi.h>
+
+// same layout as the firmware icons, frames start with a 0x00 header byte followed by raw xbm data
+typedef struct Icon {
+    uint16_t width;
+    uint16_t height;
+    uint8_t frame_count;
+    uint8_t frame_rate;
+    const uint8_t *const *frames;
+} Icon;
+
+uint16_t icon_get_width(const Icon *icon);
+uint16_t icon_get_height(const Icon *icon);
+const uint8_t *icon_get_frame_data(const Icon *icon, uint32_t frame);
@@ -0,0 +1,52 @@
+#pragma once
+#include <furi.h>
+
+#define RECORD_NOTIFICATION "notification"
+
+typedef struct NotificationApp NotificationApp;
+
+typedef enum {
+    NotificationMessageTypeVibro,
+    NotificationMessageTypeSoundOn,
+    NotificationMessageTypeSoundOff,
+    NotificationMessageTypeDelay,
+    NotificationMessageTypeDoNotReset,
+} NotificationMessageType;
+
+typedef struct {
+    float frequency;
+    float volume;
+} NotificationMessageDataSound;
+
+typedef struct {
+    uint32_t length;
+} NotificationMessageDataDelay;
+
+typedef struct {
+    bool on;
+} NotificationMessageDataVibro;
+
+typedef union {
+    NotificationMessageDataSound sound;
+    NotificationMessageDataDelay delay;
+    NotificationMessageDataVibro vibro;
+} NotificationMessageData;
+
+typedef struct {
+    NotificationMessageType type;
+    NotificationMessageData data;
+} NotificationMessage;
+
+typedef const NotificationMessage *NotificationSequence[];
+
+void notification_message(NotificationApp *app, const NotificationSequence *sequence);
+void notification_message_block(NotificationApp *app, const NotificationSequence *sequence);
+
+// the system settings the host service applies, tests change them to check the sound is gated like on the device
+typedef struct {
+    float speaker_volume;
+    bool vibro_on;
+    bool stealth;
+} NotificationHostSettings;
+
+extern NotificationHostSettings notification_host_settings;
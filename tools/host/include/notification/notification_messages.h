@@ -0,0 +1,11 @@
+#pragma once
+#include <notification/notification.h>
+
+extern const NotificationSequence sequence_display_backlight_enforce_on;
+extern const NotificationSequence sequence_display_backlight_enforce_auto;
+
+extern const NotificationMessage message_do_not_reset;
+
+extern const NotificationSequence sequence_reset_sound;
+extern const NotificationSequence sequence_set_vibro_on;
+extern const NotificationSequence sequence_reset_vibro;
@@ -0,0 +1,9 @@
+#pragma once
+#include <furi.h>
+
+typedef struct CompressIcon CompressIcon;
+
+CompressIcon *compress_icon_alloc(size_t decode_buf_size);
+void compress_icon_free(CompressIcon *instance);
+// only uncompressed frames (0x00 header) are supported on the host
+void compress_icon_decode(CompressIcon *instance, const uint8_t *icon_data, uint8_t **output);
@@ -0,0 +1,299 @@
+#!/usr/bin/env python3
+"""Converts music into the compressed stream played by play_audio_file (f0ge/utils/music_stream.h).
+
+    python3 music_convert.py song.txt song.f0mu
+    python3 music_convert.py --bpm 120 --separation 0.1 --loop music.h song.f0mu
+
+Text input, a '#' at the start of a word starts a comment:
+
+    bpm 140
+    separation 0.1          # gap between the notes, in beats
+    loop yes
+    pattern riff            # patterns can play earlier patterns
+      C4 1/4 E4 1/4 G4 1/2
+    end
+    song
+      @riff*2 R 1 BUZZ 1/4 A#3 0.5
+    end
+
+Notes are a name with an octave (C4, D#5, Eb3), R for a rest or BUZZ for the vibro motor, each followed by its
+length in beats (0-4). @name plays a pattern, @name*n plays it n times.
+
+C input: the ENCODE_NOTE(NOTE_X, octave, length) entries of a MusicData array up to NOTE_END, the tempo comes
+from the options. Repeated runs of notes in the song are turned into patterns automatically in both cases.
+"""
+import argparse
+import re
+import struct
+import sys
+from collections import Counter
+from fractions import Fraction
+
+VERSION = 1
+LENGTH_SLOTS = 7
+LENGTH_INLINE = 7
+MAX_PATTERNS = 32
+MAX_DEPTH = 4
+OP_OCTAVE = 0x80
+OP_CALL = 0x90
+OP_RETURN = 0x91
+OP_END = 0xFF
+REST = 12
+BUZZ = 13
+
+NOTE_NAMES = {'C': 0, 'D': 2, 'E': 4, 'F': 5, 'G': 7, 'A': 9, 'B': 11}
+C_NOTES = {'NOTE_C': 0, 'NOTE_CS': 1, 'NOTE_D': 2, 'NOTE_DS': 3, 'NOTE_E': 4, 'NOTE_F': 5, 'NOTE_FS': 6,
+           'NOTE_G': 7, 'NOTE_GS': 8, 'NOTE_A': 9, 'NOTE_AS': 10, 'NOTE_B': 11, 'NOTE_NONE': REST,
+           'NOTE_BUZZ': BUZZ, 'NOTE_END': None}
+
+
+class MusicError(Exception):
+    pass
+
+
+def scale_length(beats):
+    """SCALE_NOTE_LENGTH of audio.h"""
+    if not 0 <= beats <= 4:
+        raise MusicError(f'note length {beats} is outside 0-4 beats')
+    return int(beats / 4.0 * 65535.0)
+
+
+def parse_note(token, length):
+    """(note, octave, scaled length)"""
+    upper = token.upper()
+    if upper in ('R', 'REST'):
+        return REST, 0, scale_length(length)
+    if upper == 'BUZZ':
+        return BUZZ, 0, scale_length(length)
+    match = re.fullmatch(r'([A-Ga-g])([#sb]?)(\d)', token)
+    if not match:
+        raise MusicError(f'unknown note {token}')
+    note = NOTE_NAMES[match.group(1).upper()] + {'': 0, '#': 1, 's': 1, 'b': -1}[match.group(2)]
+    octave = int(match.group(3))
+    if note < 0:
+        note, octave = 11, octave - 1
+    if note > 11:
+        note, octave = 0, octave + 1
+    if not 0 <= octave <= 15:
+        raise MusicError(f'octave of {token} is out of range')
+    return note, octave, scale_length(length)
+
+
+class Music:
+    def __init__(self):
+        self.bpm = 120
+        self.separation = 0.0
+        self.loop = False
+        self.patterns = []          # bodies, items are notes or ('call', index, repeats)
+        self.pattern_names = {}
+        self.song = None
+
+
+def parse_text(lines):
+    music = Music()
+    body = None
+    for number, line in enumerate(lines, 1):
+        words = re.sub(r'(^|\s)#.*', '', line).split()
+        if not words:
+            continue
+        try:
+            if body is None:
+                key = words[0]
+                if key == 'bpm':
+                    music.bpm = int(words[1])
+                elif key == 'separation':
+                    music.separation = float(Fraction(words[1]))
+                elif key == 'loop':
+                    music.loop = words[1].lower() in ('1', 'yes', 'true')
+                elif key == 'pattern':
+                    if words[1] in music.pattern_names:
+                        raise MusicError(f'pattern {words[1]} is declared twice')
+                    body, name = [], words[1]
+                elif key == 'song':
+                    if music.song is not None:
+                        raise MusicError('there is only one song block')
+                    body, name = [], None
+                else:
+                    raise MusicError(f'unknown setting {key}')
+                continue
+            if words == ['end']:
+                if name is None:
+                    music.song = body
+                else:
+                    music.pattern_names[name] = len(music.patterns)
+                    music.patterns.append(body)
+                body = None
+                continue
+            tokens = iter(words)
+            for token in tokens:
+                if token.startswith('@'):
+                    pattern, _, repeats = token[1:].partition('*')
+                    if pattern not in music.pattern_names:
+                        raise MusicError(f'pattern {pattern} has to be declared before it is played')
+                    body.append(('call', music.pattern_names[pattern], int(repeats or 1)))
+                else:
+                    length = next(tokens, None)
+                    if length is None:
+                        raise MusicError(f'{token} needs a length')
+                    body.append(parse_note(token, float(Fraction(length))))
+        except (IndexError, ValueError, MusicError) as error:
+            raise MusicError(f'line {number}: {error}') from None
+    if body is not None:
+        raise MusicError('missing end')
+    if music.song is None:
+        raise MusicError('missing song block')
+    return music
+
+
+def parse_c(text, options):
+    music = Music()
+    music.bpm, music.separation, music.loop = options.bpm, options.separation, options.loop
+    music.song = []
+    for match in re.finditer(r'ENCODE_NOTE\s*\(\s*(\w+)\s*,\s*(\d+)\s*,\s*([\d.]+)f?\s*\)', text):
+        if match.group(1) not in C_NOTES:
+            raise MusicError(f'unknown note {match.group(1)}')
+        note = C_NOTES[match.group(1)]
+        if note is None:
+            break
+        music.song.append((note, int(match.group(2)), scale_length(float(match.group(3)))))
+    if not music.song:
+        raise MusicError('no ENCODE_NOTE entries found')
+    return music
+
+
+def find_repeats(notes, music):
+    """replaces runs of a repeated block of notes with pattern calls, greedy by saved notes"""
+    out = []
+    i = 0
+    while i < len(notes):
+        best = None
+        for size in range(2, min(32, (len(notes) - i) // 2) + 1):
+            block = notes[i:i + size]
+            repeats = 1
+            while notes[i + repeats * size:i + (repeats + 1) * size] == block and repeats < 255:
+                repeats += 1
+            saved = size * (repeats - 1)
+            if repeats > 1 and saved >= 4 and (best is None or saved > best[2]):
+                best = (size, repeats, saved)
+        if best:
+            size, repeats, _ = best
+            block = notes[i:i + size]
+            if block in music.patterns:
+                index = music.patterns.index(block)
+            elif len(music.patterns) < MAX_PATTERNS:
+                index = len(music.patterns)
+                music.patterns.append(block)
+            else:
+                index = None
+            if index is not None:
+                out.append(('call', index, repeats))
+                i += size * repeats
+                continue
+        out.append(notes[i])
+        i += 1
+    return out
+
+
+def compress_song(music):
+    song, run = [], []
+    for item in music.song + [None]:
+        if item is None or item[0] == 'call':
+            song += find_repeats(run, music)
+            run = []
+            if item:
+                song.append(item)
+        else:
+            run.append(item)
+    music.song = song
+
+
+def check_depth(music, body, depth=1):
+    for item in body:
+        if item[0] == 'call':
+            if depth >= MAX_DEPTH:
+                raise MusicError(f'patterns are nested deeper than {MAX_DEPTH}')
+            check_depth(music, music.patterns[item[1]], depth + 1)
+
+
+def note_count(music, body):
+    """notes played by a body, patterns expanded"""
+    return sum(note_count(music, music.patterns[item[1]]) * item[2] if item[0] == 'call' else 1 for item in body)
+
+
+def encode_body(body, lengths, terminator):
+    out = bytearray()
+    octave = None    # unknown at the start and after a pattern
+    for item in body:
+        if item[0] == 'call':
+            _, index, repeats = item
+            while repeats > 0:
+                count = min(repeats, 255)
+                out += bytes([OP_CALL, index, count])
+                repeats -= count
+            octave = None
+            continue
+        note, note_octave, length = item
+        if note < 12 and note_octave != octave:
+            out.append(OP_OCTAVE | note_octave)
+            octave = note_octave
+        if length in lengths:
+            out.append((lengths.index(length) << 4) | note)
+        else:
+            out.append((LENGTH_INLINE << 4) | note)
+            out += struct.pack('<H', length)
+    out.append(terminator)
+    return bytes(out)
+
+
+def encode(music):
+    if not 1 <= music.bpm <= 255:
+        raise MusicError('bpm has to be 1-255')
+    compress_song(music)
+    check_depth(music, music.song)
+    counts = Counter(item[2] for body in music.patterns + [music.song] for item in body if item[0] != 'call')
+    lengths = [length for length, _ in counts.most_common(LENGTH_SLOTS)]
+
+    bodies = [encode_body(body, lengths, OP_RETURN) for body in music.patterns]
+    song = encode_body(music.song, lengths, OP_END)
+    header = bytearray(b'F0MU')
+    header += struct.pack('<BBBBB', VERSION, 1 if music.loop else 0, music.bpm,
+                          min(255, round(music.separation * 255)), len(lengths))
+    header += struct.pack(f'<{len(lengths)}H', *lengths)
+    header += struct.pack('<B', len(bodies))
+    offset = len(header) + 4 * len(bodies) + 4
+    for body in bodies:
+        header += struct.pack('<I', offset)
+        offset += len(body)
+    header += struct.pack('<I', offset)
+    return bytes(header) + b''.join(bodies) + song
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().split('\n\n')[0])
+    parser.add_argument('source')
+    parser.add_argument('target')
+    parser.add_argument('--bpm', type=int, default=120, help='tempo of C input')
+    parser.add_argument('--separation', type=float, default=0.0, help='note separation of C input')
+    parser.add_argument('--loop', action='store_true', help='loop C input')
+    options = parser.parse_args()
+    try:
+        with open(options.source) as source:
+            text = source.read()
+        if options.source.endswith(('.c', '.h')):
+            music = parse_c(text, options)
+        else:
+            music = parse_text(text.splitlines())
+        notes = note_count(music, music.song)
+        encoded = encode(music)
+    except MusicError as error:
+        print(f'{options.source}: {error}', file=sys.stderr)
+        return 1
+    with open(options.target, 'wb') as target:
+        target.write(encoded)
+    print(f'{options.target}: {len(encoded)} bytes, {len(music.patterns)} patterns '
+          f'({notes * 4} bytes as ENCODE_NOTE)')
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,207 @@
+#!/usr/bin/env python3
+"""Converts a text scene description into the binary format read by scene_load (f0ge/scene.h).
+
+    python3 scene_convert.py level1.txt level1.f0sc
+
+One record per line, '#' starts a comment, values are key=value pairs:
+
+    sprite <name> [asset=<name>] [mask=<name>] [color=black|white|flip|set] [mask_color=...]
+                  [tile=none|horizontal|vertical|both] [flip=none|horizontal|vertical]
+                  [rect=x,y,w,h | corners=x0,y0,...,x3,y3] [uv=u0,v0,...,u3,v3]
+    node <name> [parent=<name>] [pos=x,y] [scale=x,y] [rot=degrees] [sprite=<name>]
+                [static] [scroll_layer] [sleeping]
+    component <type> node=<name> [data=<type>:<value>,...]
+
+The first node is the root and has no parent, every other parent has to be declared before its children.
+Asset and component type names are looked up in the SceneRegistry of the game while loading.
+Component data is packed like a C struct of the listed fields (natural alignment, padded to the largest
+field), types: i8 u8 i16 u16 i32 u32 f32 bool. Its size has to match SceneComponent.data_size.
+"""
+import shlex
+import struct
+import sys
+
+VERSION = 1
+NONE = 0xFFFF
+NAME_LENGTH = 32
+
+COLORS = {'black': 0, 'white': 1, 'flip': 2, 'set': 3}
+TILES = {'none': 0, 'horizontal': 1, 'vertical': 2, 'both': 3}
+FLIPS = {'none': 0, 'horizontal': 1, 'vertical': 2}
+FLAGS = {'static': 1 << 0, 'scroll_layer': 1 << 1, 'sleeping': 1 << 2}
+FIELDS = {'i8': 'b', 'u8': 'B', 'i16': 'h', 'u16': 'H', 'i32': 'i', 'u32': 'I', 'f32': 'f', 'bool': '?'}
+
+
+class SceneError(Exception):
+    pass
+
+
+def floats(text, count, key):
+    values = [float(v) for v in text.split(',')]
+    if len(values) != count:
+        raise SceneError(f'{key} needs {count} numbers')
+    return values
+
+
+def pack_data(text):
+    """packs the fields like the C compiler lays out a struct"""
+    data = bytearray()
+    largest = 1
+    for field in text.split(','):
+        kind, _, value = field.partition(':')
+        if kind not in FIELDS:
+            raise SceneError(f'unknown field type {kind}')
+        fmt = '<' + FIELDS[kind]
+        size = struct.calcsize(fmt)
+        largest = max(largest, size)
+        data += bytes(-len(data) % size)
+        if kind == 'f32':
+            data += struct.pack(fmt, float(value))
+        elif kind == 'bool':
+            data += struct.pack(fmt, value.lower() in ('1', 'true', 'yes'))
+        else:
+            data += struct.pack(fmt, int(value, 0))
+    data += bytes(-len(data) % largest)
+    return bytes(data)
+
+
+class Scene:
+    def __init__(self):
+        self.assets = []
+        self.types = []
+        self.sprites = []
+        self.sprite_names = {}
+        self.nodes = []
+        self.node_names = {}
+        self.components = []
+
+    def intern(self, table, name):
+        if len(name.encode()) >= NAME_LENGTH:
+            raise SceneError(f'{name} is longer than {NAME_LENGTH - 1} characters')
+        if name not in table:
+            table.append(name)
+        return table.index(name)
+
+    def add_sprite(self, name, options):
+        if name in self.sprite_names:
+            raise SceneError(f'sprite {name} is declared twice')
+        corners = [0, 0, 1, 0, 1, 1, 0, 1]
+        if 'rect' in options:
+            x, y, w, h = floats(options.pop('rect'), 4, 'rect')
+            corners = [x, y, x + w, y, x + w, y + h, x, y + h]
+        if 'corners' in options:
+            corners = floats(options.pop('corners'), 8, 'corners')
+        uv = floats(options.pop('uv'), 8, 'uv') if 'uv' in options else [0, 0, 1, 0, 1, 1, 0, 1]
+        asset = options.pop('asset', None)
+        mask = options.pop('mask', None)
+        record = struct.pack('<HHBBBB',
+                             self.intern(self.assets, asset) if asset else NONE,
+                             self.intern(self.assets, mask) if mask else NONE,
+                             COLORS[options.pop('color', 'black')],
+                             COLORS[options.pop('mask_color', 'black')],
+                             TILES[options.pop('tile', 'none')],
+                             FLIPS[options.pop('flip', 'none')])
+        record += struct.pack('<16f', *corners, *uv)
+        self.sprite_names[name] = len(self.sprites)
+        self.sprites.append(record)
+
+    def add_node(self, name, options):
+        if name in self.node_names:
+            raise SceneError(f'node {name} is declared twice')
+        parent = options.pop('parent', None)
+        if not self.nodes and parent:
+            raise SceneError('the first node is the root and cannot have a parent')
+        if self.nodes and not parent:
+            raise SceneError(f'node {name} needs a parent')
+        if parent and parent not in self.node_names:
+            raise SceneError(f'parent {parent} has to be declared before {name}')
+        sprite = options.pop('sprite', None)
+        if sprite and sprite not in self.sprite_names:
+            raise SceneError(f'unknown sprite {sprite}')
+        flags = 0
+        for flag, bit in FLAGS.items():
+            if options.pop(flag, None) is not None:
+                flags |= bit
+        record = struct.pack('<hHB5f',
+                             self.node_names[parent] if parent else -1,
+                             self.sprite_names[sprite] if sprite else NONE,
+                             flags,
+                             *floats(options.pop('pos', '0,0'), 2, 'pos'),
+                             *floats(options.pop('scale', '1,1'), 2, 'scale'),
+                             float(options.pop('rot', '0')))
+        self.node_names[name] = len(self.nodes)
+        self.nodes.append(record)
+
+    def add_component(self, type_name, options):
+        node = options.pop('node', None)
+        if node not in self.node_names:
+            raise SceneError(f'component {type_name} needs a declared node')
+        data = pack_data(options.pop('data')) if 'data' in options else b''
+        self.components.append((self.node_names[node], self.intern(self.types, type_name), data))
+
+    def encode(self):
+        if not self.nodes:
+            raise SceneError('the scene has no nodes')
+        data_size = sum((len(data) + 7) & ~7 for _, _, data in self.components)
+        out = bytearray(b'F0SC')
+        out += struct.pack('<BBHHHHHI', VERSION, 0, len(self.nodes), len(self.sprites), len(self.components),
+                           len(self.assets), len(self.types), data_size)
+        for name in self.assets + self.types:
+            encoded = name.encode()
+            out += struct.pack('<B', len(encoded)) + encoded
+        for record in self.sprites + self.nodes:
+            out += record
+        for node, type_index, data in self.components:
+            out += struct.pack('<HHH', node, type_index, len(data)) + data
+        return bytes(out)
+
+
+def parse(lines):
+    scene = Scene()
+    for number, line in enumerate(lines, 1):
+        words = shlex.split(line, comments=True)
+        if not words:
+            continue
+        try:
+            if len(words) < 2:
+                raise SceneError('expected <record> <name>')
+            kind, name = words[0], words[1]
+            options = {}
+            for word in words[2:]:
+                key, has_value, value = word.partition('=')
+                options[key] = value if has_value else ''
+            if kind == 'sprite':
+                scene.add_sprite(name, options)
+            elif kind == 'node':
+                scene.add_node(name, options)
+            elif kind == 'component':
+                scene.add_component(name, options)
+            else:
+                raise SceneError(f'unknown record {kind}')
+            if options:
+                raise SceneError('unknown options ' + ', '.join(options))
+        except (SceneError, KeyError, ValueError) as error:
+            raise SceneError(f'line {number}: {error}') from None
+    return scene
+
+
+def main():
+    if len(sys.argv) != 3:
+        print(__doc__.strip().split('\n\n')[1], file=sys.stderr)
+        return 2
+    try:
+        with open(sys.argv[1]) as source:
+            scene = parse(source)
+        encoded = scene.encode()
+    except SceneError as error:
+        print(f'{sys.argv[1]}: {error}', file=sys.stderr)
+        return 1
+    with open(sys.argv[2], 'wb') as target:
+        target.write(encoded)
+    print(f'{sys.argv[2]}: {len(scene.nodes)} nodes, {len(scene.sprites)} sprites, '
+          f'{len(scene.components)} components, {len(encoded)} bytes')
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
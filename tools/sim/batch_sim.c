@@ -0,0 +1,149 @@
+#include "batch_sim.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>
+
+#define FNV_OFFSET 2166136261u
+#define FNV_PRIME 16777619u
+
+typedef struct {
+    const SimScenario *scenario;
+    SimResult *results;
+    uint32_t runs;
+    uint32_t first_seed;
+    atomic_uint next;
+} SimBatch;
+
+// state of the run on the current worker, the frame hooks find it here
+typedef struct {
+    const SimScenario *scenario;
+    void *state;
+    SimResult *result;
+    float *frame_us;
+    uint64_t frame_start;
+} SimRun;
+
+static _Thread_local SimRun *current_run;
+
+static uint64_t now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec;
+}
+
+uint32_t sim_hash(uint32_t hash, uint32_t value) {
+    for (uint8_t i = 0; i < 4; i++) {
+        hash ^= (value >> (i * 8)) & 0xFF;
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+static void on_frame_start(void *gameState, uint32_t frame) {
+    UNUSED(gameState);
+    SimRun *run = current_run;
+    if (run->scenario->script) run->scenario->script(run->state, frame);
+    run->frame_start = now_ns();
+}
+
+static void on_frame_end(void *gameState, uint32_t frame, Buffer *buffer) {
+    UNUSED(gameState);
+    SimRun *run = current_run;
+    run->frame_us[frame] = (float) (now_ns() - run->frame_start) / 1000.f;
+
+    uint32_t frame_hash = buffer_checksum(buffer);
+    run->result->trace = sim_hash(run->result->trace, frame_hash);
+
+    if (frame + 1 >= run->scenario->frames) {
+        uint32_t checksum = sim_hash(FNV_OFFSET, frame_hash);
+        if (run->scenario->state_checksum)
+            checksum = sim_hash(checksum, run->scenario->state_checksum(run->state));
+        run->result->checksum = checksum;
+        run->result->frames = frame + 1;
+        engine_exit();
+    }
+}
+
+static int compare_float(const void *a, const void *b) {
+    float fa = *(const float *) a, fb = *(const float *) b;
+    return (fa > fb) - (fa < fb);
+}
+
+static void collect_stats(SimResult *result, float *frame_us) {
+    if (result->frames == 0) return;
+    qsort(frame_us, result->frames, sizeof(float), compare_float);
+    double sum = 0;
+    for (uint32_t i = 0; i < result->frames; i++) sum += frame_us[i];
+    result->frame_min_us = frame_us[0];
+    result->frame_max_us = frame_us[result->frames - 1];
+    result->frame_mean_us = (float) (sum / result->frames);
+    result->frame_p95_us = frame_us[(result->frames - 1) * 95 / 100];
+}
+
+static void simulate(const SimScenario *scenario, uint32_t seed, SimResult *result, float *frame_us) {
+    EngineContext *context = engine_context_create();
+    engine_context_bind(context);
+
+    *result = (SimResult){.seed = seed, .trace = FNV_OFFSET};
+    SimRun run = {.scenario = scenario, .result = result, .frame_us = frame_us};
+    current_run = &run;
+
+    EngineConfig config = {0};
+    Node *root = NULL;
+    run.state = scenario->setup(seed, &config, &root);
+
+    config.headless = true;
+    config.on_frame_start = on_frame_start;
+    config.on_frame_end = on_frame_end;
+
+    const uint64_t start = now_ns();
+    init_engine(config);
+    set_scene(root);
+    start_loop();
+    result->total_ns = now_ns() - start;
+
+    if (scenario->teardown) scenario->teardown(run.state);
+    collect_stats(result, frame_us);
+
+    current_run = NULL;
+    engine_context_bind(NULL);
+    engine_context_release(context);
+}
+
+static void *worker(void *arg) {
+    SimBatch *batch = arg;
+    float *frame_us = malloc(sizeof(float) * batch->scenario->frames);
+
+    for (;;) {
+        uint32_t i = atomic_fetch_add(&batch->next, 1);
+        if (i >= batch->runs) break;
+        simulate(batch->scenario, batch->first_seed + i, &batch->results[i], frame_us);
+    }
+
+    free(frame_us);
+    return NULL;
+}
+
+uint64_t sim_run_batch(const SimScenario *scenario, uint32_t runs, uint32_t first_seed, uint32_t workers, SimResult *results) {
+    if (workers == 0) workers = 1;
+    if (workers > runs) workers = runs;
+
+    SimBatch batch = {
+        .scenario = scenario,
+        .results = results,
+        .runs = runs,
+        .first_seed = first_seed,
+    };
+    atomic_init(&batch.next, 0);
+
+    const uint64_t start = now_ns();
+    pthread_t *threads = malloc(sizeof(pthread_t) * workers);
+    for (uint32_t i = 0; i < workers; i++) {
+        pthread_create(&threads[i], NULL, worker, &batch);
+    }
+    for (uint32_t i = 0; i < workers; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    free(threads);
+    return now_ns() - start;
+}
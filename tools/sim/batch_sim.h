@@ -0,0 +1,33 @@
+#pragma once
+#include "f0ge/f0ge.h"
+
+// A scene that can be simulated many times in parallel.
+// setup runs on the worker thread with a fresh engine context bound, it fills the config and the scene root,
+// the runner forces headless mode and drives the init_engine/set_scene/start_loop lifecycle itself.
+typedef struct {
+    const char *name;
+    uint32_t frames;
+    void *(*setup)(uint32_t seed, EngineConfig *config, Node **root);
+    // scripted input, called at the start of every frame, see engine_inject_input
+    void (*script)(void *state, uint32_t frame);
+    // optional, game state mixed into the final checksum (positions, scores, ...)
+    uint32_t (*state_checksum)(void *state);
+    // releases what setup allocated, the engine is already cleaned up at this point
+    void (*teardown)(void *state);
+} SimScenario;
+
+typedef struct {
+    uint32_t seed;
+    uint32_t frames;
+    uint64_t total_ns;
+    // time spent inside the engine frame (update + render), in microseconds
+    float frame_min_us, frame_max_us, frame_mean_us, frame_p95_us;
+    uint32_t checksum;  // last frame and game state
+    uint32_t trace;     // every rendered frame, catches divergence that heals itself
+} SimResult;
+
+// runs `runs` instances of the scenario with seeds first_seed..first_seed+runs-1 on `workers` threads
+// results are indexed by run, returns the wall time of the whole batch in ns
+uint64_t sim_run_batch(const SimScenario *scenario, uint32_t runs, uint32_t first_seed, uint32_t workers, SimResult *results);
+
+uint32_t sim_hash(uint32_t hash, uint32_t value);
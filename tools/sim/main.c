@@ -0,0 +1,35 @@
+// Batch simulation runner
+// usage: f0ge_batch_sim [runs] [workers] [first seed]
+// prints one line per run and the batch throughput, runs with the same seed must produce the same checksums
+#include "batch_sim.h"
+#include <unistd.h>
+
+extern const SimScenario sim_scenario_drive;
+
+int main(int argc, char **argv) {
+    const SimScenario *scenario = &sim_scenario_drive;
+    const uint32_t cores = (uint32_t) sysconf(_SC_NPROCESSORS_ONLN);
+    const uint32_t runs = argc > 1 ? (uint32_t) strtoul(argv[1], NULL, 10) : cores * 4;
+    const uint32_t workers = argc > 2 ? (uint32_t) strtoul(argv[2], NULL, 10) : cores;
+    const uint32_t first_seed = argc > 3 ? (uint32_t) strtoul(argv[3], NULL, 10) : 1;
+    if (runs == 0) return 1;
+
+    SimResult *results = calloc(runs, sizeof(SimResult));
+    const uint64_t wall_ns = sim_run_batch(scenario, runs, first_seed, workers, results);
+
+    printf("seed,frames,total_ms,min_us,mean_us,p95_us,max_us,checksum,trace\n");
+    uint64_t frames = 0;
+    for (uint32_t i = 0; i < runs; i++) {
+        SimResult *r = &results[i];
+        printf("%u,%u,%.2f,%.1f,%.1f,%.1f,%.1f,%08x,%08x\n", r->seed, r->frames, (double) r->total_ns / 1e6,
+               r->frame_min_us, r->frame_mean_us, r->frame_p95_us, r->frame_max_us, r->checksum, r->trace);
+        frames += r->frames;
+    }
+
+    const double seconds = (double) wall_ns / 1e9;
+    fprintf(stderr, "%s: %u runs on %u workers, %.3f s, %.0f frames/s\n", scenario->name, runs,
+            MIN(workers, runs), seconds, (double) frames / seconds);
+
+    free(results);
+    return 0;
+}
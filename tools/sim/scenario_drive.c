@@ -0,0 +1,172 @@
+// The render test scene: a few cars on a tiled floor, driven by pseudo random input
+#include "batch_sim.h"
+#include "f0ge/components/cam_utils.h"
+#include "f0ge/utils/helpers.h"
+
+#define CAR_COUNT 8
+
+typedef struct {
+    float speed;
+    float max_speed;
+    float acc;
+} CarData;
+
+typedef struct {
+    uint32_t rng;
+    InputKey held[2];
+    Buffer *car_sprite;
+    Buffer *car_mask;
+    Buffer *brick_sprite;
+    RenderData car_render;
+    RenderData brick_render;
+    Component drive[CAR_COUNT];
+    Component follow;
+    CarData cars[CAR_COUNT];
+    Node *car_nodes[CAR_COUNT];
+} DriveScene;
+
+static uint32_t next_random(uint32_t *state) {
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+static void car_update(Node *self, float delta, void *data) {
+    CarData *car = data;
+    if (is_down(InputKeyUp)) car->speed += car->max_speed * car->acc * delta;
+    else if (is_down(InputKeyDown)) car->speed -= car->max_speed * car->acc * delta;
+    else car->speed *= 0.8f;
+
+    car->speed = MAX(-car->max_speed, MIN(car->max_speed, car->speed));
+
+    if (is_down(InputKeyLeft)) self->transform.rotation -= delta * car->speed;
+    if (is_down(InputKeyRight)) self->transform.rotation += delta * car->speed;
+
+    Vector forward;
+    matrix_forward(&(self->transform.transformation_matrix), &forward);
+    vector_normalized(&forward, &forward);
+    self->transform.position.x += car->speed * delta * forward.y;
+    self->transform.position.y -= car->speed * delta * forward.x;
+    self->transform.dirty = true;
+}
+
+static void *drive_setup(uint32_t seed, EngineConfig *config, Node **root) {
+    DriveScene *scene = allocate(sizeof(DriveScene));
+    check_pointer(scene);
+    scene->rng = seed * 2654435761u + 1;
+    scene->held[0] = scene->held[1] = InputKeyMAX;
+
+    scene->car_sprite = buffer_create(24, 36, false);
+    buffer_fill_rect(scene->car_sprite, 0, 0, 24, 36, COLOR_BLACK);
+    buffer_fill_rect(scene->car_sprite, 4, 6, 16, 10, COLOR_WHITE);
+    scene->car_mask = buffer_create(24, 36, false);
+    buffer_fill(scene->car_mask, COLOR_BLACK);
+
+    scene->brick_sprite = buffer_create(16, 16, false);
+    buffer_fill_rect(scene->brick_sprite, 0, 0, 16, 1, COLOR_BLACK);
+    buffer_fill_rect(scene->brick_sprite, 0, 8, 16, 1, COLOR_BLACK);
+    buffer_fill_rect(scene->brick_sprite, 0, 0, 1, 8, COLOR_BLACK);
+    buffer_fill_rect(scene->brick_sprite, 8, 8, 1, 8, COLOR_BLACK);
+
+    scene->car_render = (RenderData) {
+        .poly = RECTANGLE(-12, -18, 12, 18),
+        .tile_mode = TILE_NONE,
+        .color = COLOR_BLACK,
+        .mask_color = COLOR_WHITE,
+        .sprite = scene->car_sprite,
+        .mask = scene->car_mask,
+    };
+    scene->brick_render = (RenderData) {
+        .poly = RECTANGLE(0, 0, 16, 16),
+        .tile_mode = TILE_BOTH,
+        .color = COLOR_BLACK,
+        .sprite = scene->brick_sprite,
+    };
+
+    cam_follow_set_directions(FollowLeft | FollowRight | FollowUp | FollowDown);
+    cam_follow_set_area(10, 10, 5, 5);
+
+    Node *scene_root = allocate(sizeof(Node));
+    *scene_root = MAKE_NODE();
+
+    Node *brick = allocate(sizeof(Node));
+    *brick = MAKE_NODE();
+    brick->sprite = &(scene->brick_render);
+    brick->transform.position = (Vector) {0, 60};
+    brick->transform.scale = (Vector) {10, 10};
+    add_child(scene_root, brick);
+
+    for (uint8_t i = 0; i < CAR_COUNT; i++) {
+        scene->cars[i] = (CarData) {.max_speed = 100, .acc = 0.3f + 0.05f * i};
+        scene->drive[i] = MAKE_COMPONENT();
+        scene->drive[i].update = &car_update;
+        scene->drive[i].data = &(scene->cars[i]);
+
+        Node *car = allocate(sizeof(Node));
+        *car = MAKE_NODE();
+        car->sprite = &(scene->car_render);
+        car->transform.position = (Vector) {16 + 28 * (i % 4), 20 + 40 * (i / 4)};
+        add_component(car, &(scene->drive[i]));
+        if (i == 0) add_component(car, &com_camera_follow);
+        add_child(scene_root, car);
+        scene->car_nodes[i] = car;
+    }
+
+    config->render_fps = 30;
+    config->gameState = scene;
+    *root = scene_root;
+    return scene;
+}
+
+// holds one or two keys and changes them every few frames
+static void drive_script(void *state, uint32_t frame) {
+    DriveScene *scene = state;
+    if (frame % 12 != 0) return;
+
+    for (uint8_t i = 0; i < 2; i++) {
+        if (scene->held[i] != InputKeyMAX) engine_inject_input(scene->held[i], InputTypeRelease);
+    }
+
+    static const InputKey throttle[] = {InputKeyUp, InputKeyUp, InputKeyDown, InputKeyMAX};
+    static const InputKey steering[] = {InputKeyLeft, InputKeyRight, InputKeyMAX};
+    const uint32_t r = next_random(&(scene->rng));
+    scene->held[0] = throttle[r % 4];
+    scene->held[1] = steering[(r >> 8) % 3];
+
+    for (uint8_t i = 0; i < 2; i++) {
+        if (scene->held[i] != InputKeyMAX) engine_inject_input(scene->held[i], InputTypePress);
+    }
+}
+
+static uint32_t drive_checksum(void *state) {
+    DriveScene *scene = state;
+    uint32_t hash = 2166136261u;
+    for (uint8_t i = 0; i < CAR_COUNT; i++) {
+        Transform *t = &(scene->car_nodes[i]->transform);
+        hash = sim_hash(hash, (uint32_t) (int32_t) roundf(t->position.x * 256));
+        hash = sim_hash(hash, (uint32_t) (int32_t) roundf(t->position.y * 256));
+        hash = sim_hash(hash, (uint32_t) (int32_t) roundf(t->rotation * 256));
+    }
+    return hash;
+}
+
+// the nodes were released by the engine cleanup
+static void drive_teardown(void *state) {
+    DriveScene *scene = state;
+    buffer_release(scene->car_sprite);
+    buffer_release(scene->car_mask);
+    buffer_release(scene->brick_sprite);
+    release(scene);
+}
+
+const SimScenario sim_scenario_drive = {
+    .name = "drive",
+    .frames = 600,
+    .setup = drive_setup,
+    .script = drive_script,
+    .state_checksum = drive_checksum,
+    .teardown = drive_teardown,
+};
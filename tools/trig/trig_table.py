@@ -0,0 +1,49 @@
+#!/usr/bin/env python3
+"""Writes the quarter wave sine tables of the table based sincos (f0ge/math/trig.h).
+
+    python3 trig_table.py ../../f0ge/math/trig_table.c
+    python3 trig_table.py --bits 6 8 10 12 trig_table.c
+
+One table per size, TRIG_TABLE_BITS picks the one that is compiled. A table of 2^bits steps from 0 to 90 degrees
+has 2^bits + 1 entries, the last one is sin(90) so the interpolation never reads past the end.
+"""
+import argparse
+import math
+import sys
+
+
+def table_source(bits):
+    steps = 1 << bits
+    values = ['%.9ff' % math.sin(math.pi / 2 * i / steps) for i in range(steps + 1)]
+    lines = []
+    for start in range(0, len(values), 6):
+        lines.append('    ' + ', '.join(values[start:start + 6]) + ',')
+    return '\n'.join(lines)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('output', nargs='?', help='C source to write, stdout if missing')
+    parser.add_argument('--bits', type=int, nargs='+', default=[6, 8, 10], help='table sizes as powers of two')
+    args = parser.parse_args()
+
+    out = ['// generated by tools/trig/trig_table.py, do not edit', '#include "trig.h"', '']
+    for index, bits in enumerate(sorted(set(args.bits))):
+        out.append('%s TRIG_TABLE_BITS == %d' % ('#if' if index == 0 else '#elif', bits))
+        out.append('const float trig_sine_table[TRIG_TABLE_SIZE + 1] = {')
+        out.append(table_source(bits))
+        out.append('};')
+    out.append('#else')
+    out.append('#error "no sine table of this size, add it with tools/trig/trig_table.py --bits"')
+    out.append('#endif')
+    source = '\n'.join(out) + '\n'
+
+    if args.output:
+        with open(args.output, 'w') as file:
+            file.write(source)
+    else:
+        sys.stdout.write(source)
+
+
+if __name__ == '__main__':
+    main()